@@ -0,0 +1,60 @@
+﻿/* 
+ *        Interpolation version 
+ */
+
+#version 430 core
+in vec2 v_source_pos;
+
+layout (location = 0) out uint o_reprojection;
+
+
+
+///// Packing /////
+// Packing constants
+const uint depthBits = 11u;
+const uint xBits = 11u;
+const uint yBits = 10u;
+
+const uint maxDepth = (1u << depthBits) - 1u;
+const uint minX = uint(-(1 << (xBits - 1u)));
+const uint maxX =  (1u << (xBits - 1u)) - 1u;
+const uint minY = uint(-(1 << (yBits - 1u)));
+const uint maxY =  (1u << (yBits - 1u)) - 1u;
+
+// Pack (depth, relativePos.xy) to 11/11/10 uint
+// Depth precision: 0.0004882
+// RelativePos.x range: [-1024, 1023]
+// RelativePos.y range: [-512, 511]
+uint packReprojectionDataToUint(float depth, ivec2 sourcePos, ivec2 targetPos)
+{
+    uint uDepth = uint(float(maxDepth) * depth);
+    ivec2 relativePos = clamp(targetPos - sourcePos, ivec2(minX, minY), ivec2(maxX, maxY));
+    uvec2 uRelativePos = uvec2(relativePos - ivec2(minX, minY));
+
+    uint result = (uDepth << (32u - depthBits)) | (uRelativePos.x << yBits) | (uRelativePos.y);
+
+    return result;
+}
+
+
+
+#ifdef ENABLE_RASTER_MESH
+// Triangles covering more than 2x2 target pixels per source pixel span a disocclusion, those are left to Fill
+#define MIN_SOURCE_AREA 0.25
+#endif
+
+void main()
+{
+#ifdef ENABLE_RASTER_MESH
+    vec2 sourceDx = dFdx(v_source_pos);
+    vec2 sourceDy = dFdy(v_source_pos);
+    if (abs(sourceDx.x * sourceDy.y - sourceDx.y * sourceDy.x) < MIN_SOURCE_AREA)
+    {
+        discard;
+    }
+#endif
+    // Nearest source pixel, the depth is the one the depth test resolved
+    ivec2 sourcePos = ivec2(floor(v_source_pos));
+    ivec2 targetPos = ivec2(gl_FragCoord.xy);
+    o_reprojection = packReprojectionDataToUint(gl_FragCoord.z, sourcePos, targetPos);
+}
\ No newline at end of file
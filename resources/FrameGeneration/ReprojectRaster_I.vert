@@ -0,0 +1,94 @@
+﻿/* 
+ *        Interpolation version 
+ */
+
+#version 430 core
+#ifdef ENABLE_GEOMETRY_BUFFER
+layout (binding = 0) uniform usampler2D r_current_geometry;
+layout (binding = 2) uniform usampler2D r_previous_geometry;
+#else
+layout (binding = 0) uniform sampler2D r_current_depth;
+layout (binding = 1) uniform sampler2D r_current_motion_vector;
+layout (binding = 2) uniform sampler2D r_previous_motion_vector;
+#endif
+
+// Center of the source pixel in LR pixels
+out vec2 v_source_pos;
+
+
+
+///// Uniforms /////
+layout (binding = 10, std140) uniform cb_t
+{
+    vec4 render_size;
+    vec4 presentation_size;
+    vec4 delta;
+    vec2 jitter_offset;
+    float depth_diff_threshold_sr;
+    float color_diff_threshold_fg;
+    float depth_diff_threshold_fg;
+    float depth_scale;
+    float depth_bias;
+    float render_scale;
+} cb;
+
+
+
+
+///// Geometry /////
+// Dilated depth and motion vectors. ENABLE_GEOMETRY_BUFFER reads both from one RG32UI texture per frame
+// (depth bits in x, packHalf2x16 motion vector in y).
+#ifdef ENABLE_GEOMETRY_BUFFER
+float loadCurrentDepth(ivec2 pos)
+{
+    return uintBitsToFloat(texelFetch(r_current_geometry, pos, 0).x);
+}
+
+vec2 loadCurrentMotionVector(ivec2 pos)
+{
+    return unpackHalf2x16(texelFetch(r_current_geometry, pos, 0).y);
+}
+
+vec2 loadPreviousMotionVector(ivec2 pos)
+{
+    return unpackHalf2x16(texelFetch(r_previous_geometry, pos, 0).y);
+}
+#else
+float loadCurrentDepth(ivec2 pos)
+{
+    return texelFetch(r_current_depth, pos, 0).x;
+}
+
+vec2 loadCurrentMotionVector(ivec2 pos)
+{
+    return texelFetch(r_current_motion_vector, pos, 0).xy;
+}
+
+vec2 loadPreviousMotionVector(ivec2 pos)
+{
+    return texelFetch(r_previous_motion_vector, pos, 0).xy;
+}
+#endif
+
+
+
+// One vertex per LR pixel (gl_VertexID = y * width + x), drawn as points or as a triangle strip grid. The hardware
+// depth test keeps the nearest source in place of the atomic minimum of Reproject_I.
+void main()
+{
+    int width = int(cb.render_size.x);
+    ivec2 pos_t1 = ivec2(gl_VertexID % width, gl_VertexID / width);
+    vec2 uv = (vec2(pos_t1) + 0.5f) * cb.render_size.zw;
+    vec2 mv_t1 = loadCurrentMotionVector(pos_t1);
+    
+    // Quadratic motion estimation, as in Reproject_I
+    ivec2 pos_t0 = ivec2((uv - mv_t1) * cb.render_size.xy);
+    vec2 mv_t0 = loadPreviousMotionVector(pos_t0);
+    vec2 uvDelta = uv + (-1.0 + cb.delta.y + cb.delta.w) * mv_t1 + (cb.delta.y - cb.delta.w) * mv_t0;
+    
+    // Texel rows map to framebuffer rows, so no y flip. Clipping drops targets outside the screen.
+    float depth = loadCurrentDepth(pos_t1);
+    gl_Position = vec4(uvDelta * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    gl_PointSize = 1.0;
+    v_source_pos = vec2(pos_t1) + 0.5;
+}
\ No newline at end of file
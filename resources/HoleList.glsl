@@ -0,0 +1,27 @@
+///// Hole list /////
+// LR pixels that Fill may change, appended by Reproject_I. hole_mask holds one bit per LR pixel so every pixel is listed once.
+// dispatch_args: indirect dispatch over the entries, HOLE_LIST_GROUP_SIZE entries per workgroup
+// entries[i].x: packed pixel position, entries[i].y: filled reprojection written by Fill
+layout (std430, binding = 12) buffer hole_list_t
+{
+    uint dispatch_args[3];
+    uint count;
+    uvec2 entries[];
+} hole_list;
+
+layout (std430, binding = 13) buffer hole_mask_t
+{
+    uint mask[];
+} hole_mask;
+
+#define HOLE_LIST_GROUP_SIZE 64
+
+uint packPixelPos(ivec2 pos)
+{
+    return uint(pos.x) | (uint(pos.y) << 16);
+}
+
+ivec2 unpackPixelPos(uint packedPos)
+{
+    return ivec2(packedPos & 0xFFFFu, packedPos >> 16);
+}
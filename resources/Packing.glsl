@@ -38,4 +38,58 @@ ivec2 unpackSourcePosFromUint(uint reprojectionData, ivec2 targetPos)
     ivec2 relativePos = ivec2(uRelativeX, uRelativeY) + ivec2(minX, minY);
     ivec2 sourcePos = targetPos - relativePos;
     return sourcePos;
-}
\ No newline at end of file
+}
+
+
+// Format independent access, REPROJECTION_DATA is what the reprojection textures hold
+#ifdef ENABLE_WIDE_REPROJECTION
+// 64-bit format: x = relativePos.xy as 16/16, y = depth as float bits (INVALID if nothing was projected)
+// RelativePos range: [-32768, 32767]
+#define REPROJECTION_DATA uvec2
+#define INVALID_REPROJECTION uvec2(INVALID)
+
+uvec2 packReprojectionData(float depth, ivec2 sourcePos, ivec2 targetPos)
+{
+    uvec2 uRelativePos = uvec2(clamp(targetPos - sourcePos, ivec2(-32768), ivec2(32767)) + 32768);
+    return uvec2((uRelativePos.x << 16) | uRelativePos.y, floatBitsToUint(max(depth, 0.0f)));
+}
+
+float unpackReprojectionDepth(uvec2 reprojectionData)
+{
+    return reprojectionData.y == INVALID ? 1.0f : uintBitsToFloat(reprojectionData.y);
+}
+
+ivec2 unpackReprojectionSourcePos(uvec2 reprojectionData, ivec2 targetPos)
+{
+    ivec2 relativePos = ivec2(reprojectionData.x >> 16, reprojectionData.x & 0xFFFFu) - 32768;
+    return targetPos - relativePos;
+}
+
+bool isReprojectionValid(uvec2 reprojectionData)
+{
+    return reprojectionData.y != INVALID;
+}
+#else
+#define REPROJECTION_DATA uint
+#define INVALID_REPROJECTION INVALID
+
+uint packReprojectionData(float depth, ivec2 sourcePos, ivec2 targetPos)
+{
+    return packReprojectionDataToUint(depth, sourcePos, targetPos);
+}
+
+float unpackReprojectionDepth(uint reprojectionData)
+{
+    return unpackDepthFromUint(reprojectionData);
+}
+
+ivec2 unpackReprojectionSourcePos(uint reprojectionData, ivec2 targetPos)
+{
+    return unpackSourcePosFromUint(reprojectionData, targetPos);
+}
+
+bool isReprojectionValid(uint reprojectionData)
+{
+    return reprojectionData != INVALID;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+///// Subgroup /////
+// 3x3 neighborhoods through subgroup shuffles: every invocation fetches the texel at its own position once and reads
+// the texels of neighboring invocations from them instead of fetching again. Whether an invocation really holds the
+// wanted texel is checked by shuffling its position too, so this does not depend on how invocations map to subgroups,
+// texels that are not held by the subgroup are fetched as usual. Shuffles must be reached by the whole subgroup.
+
+// Invocation of this subgroup that sits at localOffset in the workgroup, if invocations are assigned in row major order
+uint getSubgroupNeighbor(ivec2 localOffset)
+{
+    ivec2 localPos = ivec2(gl_LocalInvocationID.xy) + localOffset;
+    int lane = int(gl_SubgroupInvocationID) + localOffset.x + localOffset.y * int(gl_WorkGroupSize.x);
+    bool inWorkGroup = all(greaterThanEqual(localPos, ivec2(0, 0))) && all(lessThan(localPos, ivec2(gl_WorkGroupSize.xy)));
+    return inWorkGroup && lane >= 0 && lane < int(gl_SubgroupSize) ? uint(lane) : gl_SubgroupInvocationID;
+}
+
+uint packSubgroupPos(ivec2 pos)
+{
+    return uint(pos.x) | (uint(pos.y) << 16);
+}
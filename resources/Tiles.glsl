@@ -0,0 +1,48 @@
+///// Tiles /////
+// Tile lists written by FrameGeneration/CompactTiles.comp. A tile is one 8x8 LR workgroup.
+// dispatch_args[0..2]: LR indirect dispatch over dynamic tiles
+// dispatch_args[3..5]: HR indirect dispatch over dynamic tiles (y = HR workgroups per tile)
+// dispatch_args[6..8]: HR indirect dispatch over static tiles (y = HR workgroups per tile)
+// Dynamic tiles are stored from the front of tiles[], static tiles from the back.
+layout (std430, binding = 11) readonly buffer tile_list_t
+{
+    uint dispatch_args[9];
+    uint tiles[];
+} tile_list;
+
+#define TILE_SIZE 8
+
+ivec2 unpackTile(uint packedTile)
+{
+    return ivec2(packedTile & 0xFFFFu, packedTile >> 16);
+}
+
+ivec2 getTileCount()
+{
+    return (ivec2(cb.render_size.xy) + TILE_SIZE - 1) / TILE_SIZE;
+}
+
+uint getDynamicTile()
+{
+    return tile_list.tiles[gl_WorkGroupID.x];
+}
+
+uint getStaticTile()
+{
+    ivec2 tileCount = getTileCount();
+    return tile_list.tiles[uint(tileCount.x * tileCount.y) - 1u - gl_WorkGroupID.x];
+}
+
+// LR pixel of this invocation (one workgroup per tile)
+ivec2 getTilePixelPosLR(uint packedTile)
+{
+    return unpackTile(packedTile) * TILE_SIZE + ivec2(gl_LocalInvocationID.xy);
+}
+
+// HR pixel of this invocation (render_scale^2 workgroups per tile, selected by gl_WorkGroupID.y)
+ivec2 getTilePixelPosHR(uint packedTile)
+{
+    int scale = int(cb.render_scale);
+    ivec2 subTile = ivec2(int(gl_WorkGroupID.y) % scale, int(gl_WorkGroupID.y) / scale);
+    return (unpackTile(packedTile) * scale + subTile) * TILE_SIZE + ivec2(gl_LocalInvocationID.xy);
+}
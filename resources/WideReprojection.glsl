@@ -0,0 +1,17 @@
+///// Wide reprojection /////
+// Reprojection target of the 64-bit format, one entry per LR pixel in row major order (see Packing).
+// Depth is the high word of the 64-bit value, so a 64-bit atomicMin keeps the nearest source like the packed format.
+// Without GL_NV_shader_atomic_int64 Reproject_I runs twice: atomicMin on depth, then on the payload of the winners.
+layout (std430, binding = 14) buffer wide_reprojection_t
+{
+#ifdef ENABLE_ATOMIC_INT64
+    uint64_t entries[];
+#else
+    uvec2 entries[];
+#endif
+} wide_reprojection;
+
+uint getReprojectionIndex(ivec2 pos)
+{
+    return uint(pos.y) * uint(cb.render_size.x) + uint(pos.x);
+}
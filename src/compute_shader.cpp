@@ -5,7 +5,69 @@
 #include <sstream>
 #include <glad/glad.h>
 
-ComputeShader::ComputeShader(const std::string& shaderPath)
+#ifdef ENABLE_GLES
+static void replaceAll(std::string& text, const std::string& from, const std::string& to)
+{
+	for (size_t position = text.find(from); position != std::string::npos; position = text.find(from, position + to.size()))
+	{
+		text.replace(position, from.size(), to);
+	}
+}
+
+// #version 430 core source -> #version 310 es. Returns the new #version line (plus extensions) and edits the body.
+static std::string toGLES(std::string& shaderCode)
+{
+	std::string versionLine = "#version 310 es\n";
+	if (shaderCode.find("imageAtomic") != std::string::npos)
+	{
+		versionLine += "#extension GL_OES_shader_image_atomic : require\n";
+	}
+
+	// No two-channel image formats in ES 3.1, Texture allocates four channels instead
+	replaceAll(shaderCode, "(rg16f,", "(rgba16f,");
+	replaceAll(shaderCode, "(rg32ui,", "(rgba32ui,");
+
+	// Opaque types have no default precision in compute shaders. Declared after the #extension block (directives
+	// must precede any statement), explicit mediump qualifiers in the code still apply.
+	size_t insertPosition = 0;
+	int depth = 0;
+	bool afterExtension = false;
+	for (size_t lineBegin = 0; lineBegin < shaderCode.size();)
+	{
+		size_t lineEnd = shaderCode.find('\n', lineBegin);
+		lineEnd = (lineEnd == std::string::npos) ? shaderCode.size() : lineEnd + 1;
+		const std::string line = shaderCode.substr(lineBegin, lineEnd - lineBegin);
+		if (line.compare(0, 3, "#if") == 0)
+		{
+			depth++;
+		}
+		else if (line.compare(0, 6, "#endif") == 0)
+		{
+			depth--;
+		}
+		else if (line.compare(0, 10, "#extension") == 0)
+		{
+			afterExtension = true;
+		}
+		if (afterExtension && depth == 0)
+		{
+			insertPosition = lineEnd;
+			afterExtension = false;
+		}
+		lineBegin = lineEnd;
+	}
+	shaderCode.insert(insertPosition,
+		"precision highp float;\n"
+		"precision highp int;\n"
+		"precision highp sampler2D;\n"
+		"precision highp usampler2D;\n"
+		"precision highp image2D;\n"
+		"precision highp uimage2D;\n");
+	return versionLine;
+}
+#endif
+
+std::string loadShaderSource(const std::string& shaderPath, const std::vector<std::string>& defines)
 {
 	std::string shaderCode;
 	std::ifstream shaderFile;
@@ -21,8 +83,40 @@ ComputeShader::ComputeShader(const std::string& shaderPath)
 	}
 	catch (std::ifstream::failure e)
 	{
-		std::cout << "ERROR: Cannot read compute shader from file " << shaderPath << std::endl;
+		std::cout << "ERROR: Cannot read shader from file " << shaderPath << std::endl;
 	}
+
+	// Strip UTF-8 BOM
+	if (shaderCode.compare(0, 3, "\xEF\xBB\xBF") == 0)
+	{
+		shaderCode.erase(0, 3);
+	}
+
+	// The #version directive must be the first line (some drivers reject leading comments), followed by defines
+	std::string versionLine;
+	size_t versionBegin = shaderCode.find("#version");
+	if (versionBegin != std::string::npos)
+	{
+		size_t versionEnd = shaderCode.find('\n', versionBegin);
+		versionEnd = (versionEnd == std::string::npos) ? shaderCode.size() : versionEnd + 1;
+		versionLine = shaderCode.substr(versionBegin, versionEnd - versionBegin);
+		shaderCode.erase(versionBegin, versionEnd - versionBegin);
+	}
+#ifdef ENABLE_GLES
+	versionLine = toGLES(shaderCode);
+#endif
+	std::stringstream header;
+	header << versionLine;
+	for (const std::string& define : defines)
+	{
+		header << "#define " << define << "\n";
+	}
+	return header.str() + shaderCode;
+}
+
+ComputeShader::ComputeShader(const std::string& shaderPath, const std::vector<std::string>& defines)
+{
+	const std::string shaderCode = loadShaderSource(shaderPath, defines);
 	const char* source = shaderCode.c_str();
 	
 	int success;
@@ -42,6 +136,7 @@ ComputeShader::ComputeShader(const std::string& shaderPath)
 	glAttachShader(shaderID, computeShader);
 	glLinkProgram(shaderID);
 	glGetProgramiv(shaderID, GL_LINK_STATUS, &success);
+	isLinked = success != 0;
 	if (!success) {
 		glGetProgramInfoLog(shaderID, 1024, NULL, infoLog);
 		std::cout << "ERROR: Compute shader linking failed in " << shaderPath << "\n" << infoLog << "\n";
@@ -49,6 +144,11 @@ ComputeShader::ComputeShader(const std::string& shaderPath)
 	glDeleteShader(computeShader);
 }
 
+ComputeShader::~ComputeShader()
+{
+	glDeleteProgram(shaderID);
+}
+
 void ComputeShader::use() const
 {
 	glUseProgram(shaderID);
@@ -57,5 +157,11 @@ void ComputeShader::use() const
 void ComputeShader::dispatch(int numGroupX, int numGroupY, int numGroupZ) const
 {
 	glDispatchCompute(numGroupX, numGroupY, numGroupZ);
-	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+void ComputeShader::dispatchIndirect(unsigned int indirectOffset) const
+{
+	glDispatchComputeIndirect(static_cast<GLintptr>(indirectOffset));
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
 }
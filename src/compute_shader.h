@@ -1,14 +1,26 @@
 ﻿#pragma once
 #include <string>
+#include <vector>
+
+// Reads a shader and inserts each define as "#define <define>" right after the #version directive (translated to
+// #version 310 es with ENABLE_GLES)
+std::string loadShaderSource(const std::string& shaderPath, const std::vector<std::string>& defines);
 
 class ComputeShader
 {
 public:
-    ComputeShader(const std::string& shaderPath);
+    // Each define is inserted as "#define <define>" right after the #version directive
+    ComputeShader(const std::string& shaderPath, const std::vector<std::string>& defines = {});
+    ~ComputeShader();
 
     unsigned int getID() const { return shaderID; }
+    // False with an ERROR message if compilation or linking failed
+    bool isValid() const { return isLinked; }
     void use() const;
     void dispatch(int numGroupX, int numGroupY, int numGroupZ) const;
+    // Reads group counts from the buffer bound to GL_DISPATCH_INDIRECT_BUFFER at the given byte offset
+    void dispatchIndirect(unsigned int indirectOffset) const;
 private:
     unsigned int shaderID;
+    bool isLinked;
 };
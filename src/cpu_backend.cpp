@@ -0,0 +1,1068 @@
+#include "cpu_backend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include "cpu_simd.h"
+
+// Tiles are rows of 64 pixels, 16 rows high, so SIMD row loops stay long and a tile fits in L1/L2
+static const int tileWidth = 64;
+static const int tileHeight = 16;
+
+// Offsets of the 3x3 neighborhood in the order of Dilate.comp and BlendHistory.comp
+static const int neighborOffsets[8][2] =
+{
+	{ -1, -1 },
+	{ -1, 0 },
+	{ -1, 1 },
+	{ 0, -1 },
+	{ 0, 1 },
+	{ 1, -1 },
+	{ 1, 0 },
+	{ 1, 1 },
+};
+
+// RGBA8 texel -> float with 8 bits per channel, see IO/LoadDepth.comp (works on float and FloatV)
+template <typename T>
+static T decodeRGBA8(T r, T g, T b, T a)
+{
+	return r + g * T(1.0f / 255.0f) + b * T(1.0f / (255.0f * 255.0f)) + a * T(1.0f / (255.0f * 255.0f * 255.0f));
+}
+
+static int clampInt(int value, int minValue, int maxValue)
+{
+	return std::min(std::max(value, minValue), maxValue);
+}
+
+static float fract(float value)
+{
+	return value - std::floor(value);
+}
+
+static void RGBToYCoCg(const float* color, float* result)
+{
+	result[0] = 0.25f * color[0] + 0.5f * color[1] - 0.25f * color[2];
+	result[1] = 0.5f * color[0] + 0.5f * color[2];
+	result[2] = 0.25f * color[0] - 0.5f * color[1] - 0.25f * color[2];
+}
+
+static void YCoCgToRGB(const float* color, float* result)
+{
+	result[0] = color[0] + color[1] + color[2];
+	result[1] = color[0] - color[2];
+	result[2] = -color[0] + color[1] - color[2];
+}
+
+// Sample.glsl
+static int clampCoord(int pos, int offset, int textureSize)
+{
+	int result = pos + offset;
+	result = offset < 0 ? std::max(result, 0) : result;
+	result = offset > 0 ? std::min(result, textureSize - 1) : result;
+	return result;
+}
+
+// Sample.glsl: 4x4 taps weighted by the LUT
+static void sampleWithLut(const CpuImage& image, float u, float v, float textureWidth, float textureHeight, const CpuImage& lut, float* result)
+{
+	const float fPosX = u * textureWidth;
+	const float fPosY = v * textureHeight;
+	const float centerX = std::nearbyint(fPosX);
+	const float centerY = std::nearbyint(fPosY);
+	const float dX = fPosX - centerX + 0.5f;
+	const float dY = fPosY - centerY + 0.5f;
+	// LUT: (32 * 4) * (32 * 4) = 128 * 128
+	// 0.25 = 32 / 128
+	const float lutSampleU = (31.0f * dX + 0.5f) / 128.0f;
+	const float lutSampleV = (31.0f * dY + 0.5f) / 128.0f;
+	const int samplePosX = static_cast<int>(centerX - 0.5f);
+	const int samplePosY = static_cast<int>(centerY - 0.5f);
+	const int width = static_cast<int>(textureWidth);
+	const int height = static_cast<int>(textureHeight);
+
+	const int channels = image.getChannels();
+	float weightSum = 0.0f;
+	for (int channel = 0; channel < channels; channel++)
+	{
+		result[channel] = 0.0f;
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		const int x = clampCoord(samplePosX, i - 1, width);
+		for (int j = 0; j < 4; j++)
+		{
+			float weight;
+			lut.sampleLinear(lutSampleU + static_cast<float>(i) * 0.25f, lutSampleV + static_cast<float>(j) * 0.25f, &weight);
+			const int y = clampCoord(samplePosY, j - 1, height);
+			for (int channel = 0; channel < channels; channel++)
+			{
+				result[channel] += image.fetch(channel, x, y) * weight;
+			}
+			weightSum += weight;
+		}
+	}
+	for (int channel = 0; channel < channels; channel++)
+	{
+		result[channel] /= weightSum;
+	}
+}
+
+static void atomicMin(std::atomic<uint64_t>& target, uint64_t value)
+{
+	uint64_t current = target.load(std::memory_order_relaxed);
+	while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+CpuBackend::CpuBackend(int renderWidth, int renderHeight, int presentationWidth, int presentationHeight,
+	bool enableSuperResolution, bool enableInterpolation, bool enablePushPullFill, bool enableWideReprojection,
+	bool enableNativeLRColor, bool enableCameraMotionVectors, bool enableSparseMotionVectors, bool enableGatherReprojection,
+	bool enableExtrapolation, int threadCount) :
+	renderWidth(renderWidth), renderHeight(renderHeight),
+	presentationWidth(presentationWidth), presentationHeight(presentationHeight),
+	enableSuperResolution(enableSuperResolution), enableInterpolation(enableInterpolation),
+	enablePushPullFill(enablePushPullFill), enableWideReprojection(enableWideReprojection),
+	enableNativeLRColor(enableNativeLRColor), enableCameraMotionVectors(enableCameraMotionVectors),
+	enableSparseMotionVectors(enableSparseMotionVectors), enableGatherReprojection(enableGatherReprojection),
+	enableExtrapolation(enableExtrapolation), threadPool(threadCount)
+{
+	invalidReprojection = getInvalidReprojection(enableWideReprojection);
+
+	// Raw inputs
+	if (enableSuperResolution && !enableNativeLRColor)
+	{
+		rawInputHRColor = make_shared<CpuImage>(CpuImageFormat::RGBA8, presentationWidth, presentationHeight);
+	}
+	rawInputDepth = make_shared<CpuImage>(CpuImageFormat::RGBA8, renderWidth, renderHeight);
+	if (!enableCameraMotionVectors || enableSparseMotionVectors)
+	{
+		rawInputMotionVectorX = make_shared<CpuImage>(CpuImageFormat::RGBA8, renderWidth, renderHeight);
+		rawInputMotionVectorY = make_shared<CpuImage>(CpuImageFormat::RGBA8, renderWidth, renderHeight);
+	}
+
+	// Inputs
+	inputColor = make_shared<CpuImage>(CpuImageFormat::RGBA8, renderWidth, renderHeight);
+	inputDepth = make_shared<CpuImage>(CpuImageFormat::R32F, renderWidth, renderHeight);
+	inputMotionVector = make_shared<CpuImage>(CpuImageFormat::RG16F, renderWidth, renderHeight);
+
+	sampleLut = make_shared<CpuImage>(CpuImageFormat::R16F, 128, 128);
+
+	currentDilatedDepth = make_shared<CpuImage>(CpuImageFormat::R32F, renderWidth, renderHeight);
+	currentDilatedMotionVector = make_shared<CpuImage>(CpuImageFormat::RG16F, renderWidth, renderHeight);
+	if (enableInterpolation || enableSuperResolution)
+	{
+		currentHRColor = make_shared<CpuImage>(CpuImageFormat::RGBA8, presentationWidth, presentationHeight);
+		previousDilatedDepth = make_shared<CpuImage>(CpuImageFormat::R32F, renderWidth, renderHeight);
+		previousHRColor = make_shared<CpuImage>(CpuImageFormat::RGBA8, presentationWidth, presentationHeight);
+	}
+
+	if (enableInterpolation)
+	{
+		previousDilatedMotionVector = make_shared<CpuImage>(CpuImageFormat::RG16F, renderWidth, renderHeight);
+		reprojection.reset(new std::atomic<uint64_t>[static_cast<size_t>(renderWidth) * renderHeight]);
+		filledReprojection.resize(static_cast<size_t>(renderWidth) * renderHeight);
+		resolvedMotion.resize(static_cast<size_t>(renderWidth) * renderHeight);
+		frameGenerationResult = make_shared<CpuImage>(CpuImageFormat::RGBA8, presentationWidth, presentationHeight);
+		if (enablePushPullFill)
+		{
+			// Halve down to 1x1
+			int levelWidth = renderWidth;
+			int levelHeight = renderHeight;
+			while (levelWidth > 1 || levelHeight > 1)
+			{
+				levelWidth = (levelWidth + 1) / 2;
+				levelHeight = (levelHeight + 1) / 2;
+				pushPullLevels.push_back(std::vector<uint64_t>(static_cast<size_t>(levelWidth) * levelHeight));
+				pushPullWidths.push_back(levelWidth);
+				pushPullHeights.push_back(levelHeight);
+			}
+		}
+		if (enableExtrapolation)
+		{
+			extrapolationReprojection.reset(new std::atomic<uint64_t>[static_cast<size_t>(renderWidth) * renderHeight]);
+			extrapolationFilledReprojection.resize(static_cast<size_t>(renderWidth) * renderHeight);
+			extrapolationResult = make_shared<CpuImage>(CpuImageFormat::RGBA8, presentationWidth, presentationHeight);
+		}
+	}
+}
+
+void CpuBackend::loadLUT(const std::string& path)
+{
+	sampleLut->loadLUT(path);
+}
+
+void CpuBackend::load(const std::string& colorPath, const std::string& depthPath, const std::string& motionVectorXPath, const std::string& motionVectorYPath)
+{
+	(enableSuperResolution && !enableNativeLRColor ? rawInputHRColor : inputColor)->loadFromFile(colorPath);
+	rawInputDepth->loadFromFile(depthPath);
+	if (rawInputMotionVectorX)
+	{
+		rawInputMotionVectorX->loadFromFile(motionVectorXPath);
+		rawInputMotionVectorY->loadFromFile(motionVectorYPath);
+	}
+}
+
+void CpuBackend::dispatch(int width, int height, const std::function<void(int, int, int)>& kernel)
+{
+	const int tileCountX = (width + tileWidth - 1) / tileWidth;
+	const int tileCountY = (height + tileHeight - 1) / tileHeight;
+	threadPool.parallelFor(tileCountX * tileCountY, [&](int tile)
+	{
+		const int x0 = (tile % tileCountX) * tileWidth;
+		const int y0 = (tile / tileCountX) * tileHeight;
+		const int x1 = std::min(x0 + tileWidth, width);
+		const int y1 = std::min(y0 + tileHeight, height);
+		for (int y = y0; y < y1; y++)
+		{
+			kernel(y, x0, x1);
+		}
+	});
+}
+
+void CpuBackend::swapBuffers()
+{
+	if (enableInterpolation)
+	{
+		std::swap(currentHRColor, previousHRColor);
+		std::swap(currentDilatedDepth, previousDilatedDepth);
+		std::swap(currentDilatedMotionVector, previousDilatedMotionVector);
+	}
+	else
+	{
+		if (enableSuperResolution)
+		{
+			std::swap(currentHRColor, previousHRColor);
+			std::swap(currentDilatedDepth, previousDilatedDepth);
+		}
+	}
+}
+
+void CpuBackend::processInputs(const UniformBlock& cb, const CameraBlock& camera)
+{
+	// Decode depths
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		const size_t row = static_cast<size_t>(y) * renderWidth;
+		const float* r = rawInputDepth->getPlane(0) + row;
+		const float* g = rawInputDepth->getPlane(1) + row;
+		const float* b = rawInputDepth->getPlane(2) + row;
+		const float* a = rawInputDepth->getPlane(3) + row;
+		float* depth = inputDepth->getPlane(0) + row;
+		int x = x0;
+		for (; x + FloatV::width <= x1; x += FloatV::width)
+		{
+			const FloatV d = decodeRGBA8(FloatV::load(r + x), FloatV::load(g + x), FloatV::load(b + x), FloatV::load(a + x));
+			(d * FloatV(cb.depth_scale) + FloatV(cb.depth_bias)).store(depth + x);
+		}
+		for (; x < x1; x++)
+		{
+			depth[x] = decodeRGBA8(r[x], g[x], b[x], a[x]) * cb.depth_scale + cb.depth_bias;
+		}
+	});
+
+	if (enableCameraMotionVectors)
+	{
+		reconstructMotionVectors(cb, camera);
+	}
+	else
+	{
+		decodeMotionVectors();
+	}
+
+	// Sample HR color with jittered position to generate LR color
+	if (enableSuperResolution && !enableNativeLRColor)
+	{
+		dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+		{
+			const float jitteredV = (static_cast<float>(y) + 0.5f - cb.jitter_offset.y) * cb.render_size.w;
+			const int jitteredY = static_cast<int>(jitteredV * cb.presentation_size.y);
+			for (int x = x0; x < x1; x++)
+			{
+				const float jitteredU = (static_cast<float>(x) + 0.5f - cb.jitter_offset.x) * cb.render_size.z;
+				const int jitteredX = static_cast<int>(jitteredU * cb.presentation_size.x);
+				float color[4];
+				for (int channel = 0; channel < 4; channel++)
+				{
+					color[channel] = rawInputHRColor->fetch(channel, jitteredX, jitteredY);
+				}
+				inputColor->store(x, y, color);
+			}
+		});
+	}
+}
+
+void CpuBackend::decodeMotionVectors()
+{
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		const size_t row = static_cast<size_t>(y) * renderWidth;
+		for (int channel = 0; channel < 2; channel++)
+		{
+			const CpuImage& raw = channel == 0 ? *rawInputMotionVectorX : *rawInputMotionVectorY;
+			const float* r = raw.getPlane(0) + row;
+			const float* g = raw.getPlane(1) + row;
+			const float* b = raw.getPlane(2) + row;
+			const float* a = raw.getPlane(3) + row;
+			float* motionVector = inputMotionVector->getPlane(channel) + row;
+			// Invert Y
+			const float sign = channel == 0 ? 1.0f : -1.0f;
+			int x = x0;
+			for (; x + FloatV::width <= x1; x += FloatV::width)
+			{
+				const FloatV m = decodeRGBA8(FloatV::load(r + x), FloatV::load(g + x), FloatV::load(b + x), FloatV::load(a + x));
+				((m * FloatV(2.0f) - FloatV(1.0f)) * FloatV(sign)).store(motionVector + x);
+			}
+			for (; x < x1; x++)
+			{
+				motionVector[x] = (decodeRGBA8(r[x], g[x], b[x], a[x]) * 2.0f - 1.0f) * sign;
+			}
+			inputMotionVector->quantizeRow(channel, y, x0, x1);
+		}
+	});
+}
+
+// ReconstructMotionVector.comp
+void CpuBackend::reconstructMotionVectors(const UniformBlock& cb, const CameraBlock& camera)
+{
+	const float* m = camera.reprojection.m;
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		const size_t row = static_cast<size_t>(y) * renderWidth;
+		const float* depth = inputDepth->getPlane(0) + row;
+		float* motionVectorX = inputMotionVector->getPlane(0) + row;
+		float* motionVectorY = inputMotionVector->getPlane(1) + row;
+		const float v = (static_cast<float>(y) + 0.5f) * cb.render_size.w;
+		for (int x = x0; x < x1; x++)
+		{
+			if (enableSparseMotionVectors)
+			{
+				// Pixels of dynamic objects have a nonzero channel in either input
+				float raw[2][4];
+				bool isDynamic = false;
+				for (int channel = 0; channel < 4; channel++)
+				{
+					raw[0][channel] = rawInputMotionVectorX->getPlane(channel)[row + x];
+					raw[1][channel] = rawInputMotionVectorY->getPlane(channel)[row + x];
+					isDynamic = isDynamic || raw[0][channel] != 0.0f || raw[1][channel] != 0.0f;
+				}
+				if (isDynamic)
+				{
+					// Invert Y
+					motionVectorX[x] = decodeRGBA8(raw[0][0], raw[0][1], raw[0][2], raw[0][3]) * 2.0f - 1.0f;
+					motionVectorY[x] = -(decodeRGBA8(raw[1][0], raw[1][1], raw[1][2], raw[1][3]) * 2.0f - 1.0f);
+					continue;
+				}
+			}
+			const float u = (static_cast<float>(x) + 0.5f) * cb.render_size.z;
+			const float ndc[4] = { u * 2.0f - 1.0f, 1.0f - v * 2.0f, depth[x] * 2.0f - 1.0f, 1.0f };
+			float previousClip[4];
+			for (int i = 0; i < 4; i++)
+			{
+				previousClip[i] = m[i] * ndc[0] + m[4 + i] * ndc[1] + m[8 + i] * ndc[2] + m[12 + i] * ndc[3];
+			}
+			const float previousU = previousClip[0] / previousClip[3] * 0.5f + 0.5f;
+			const float previousV = 0.5f - previousClip[1] / previousClip[3] * 0.5f;
+			motionVectorX[x] = u - previousU;
+			motionVectorY[x] = v - previousV;
+		}
+		inputMotionVector->quantizeRow(0, y, x0, x1);
+		inputMotionVector->quantizeRow(1, y, x0, x1);
+	});
+}
+
+void CpuBackend::preprocess()
+{
+	// Dilate
+	const float* depth = inputDepth->getPlane(0);
+	auto dilatePixel = [&](int x, int y)
+	{
+		int nearestX = x;
+		int nearestY = y;
+		float nearestDepth = inputDepth->fetch(0, x, y);
+		for (int i = 0; i < 8; i++)
+		{
+			const int sampleX = clampInt(x + neighborOffsets[i][0], 0, renderWidth);
+			const int sampleY = clampInt(y + neighborOffsets[i][1], 0, renderHeight);
+			const float d = inputDepth->fetch(0, sampleX, sampleY);
+			if (d < nearestDepth)
+			{
+				nearestX = sampleX;
+				nearestY = sampleY;
+				nearestDepth = d;
+			}
+		}
+		const float motionVector[2] = { inputMotionVector->fetch(0, nearestX, nearestY), inputMotionVector->fetch(1, nearestX, nearestY) };
+		currentDilatedDepth->store(x, y, &nearestDepth);
+		currentDilatedMotionVector->store(x, y, motionVector);
+	};
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		int x = x0;
+		if (y > 0 && y < renderHeight - 1)
+		{
+			// Neighborhoods inside the image, nearest neighbor index per lane (-1 = center)
+			for (; x < std::min(std::max(x0, 1), x1); x++)
+			{
+				dilatePixel(x, y);
+			}
+			const int interiorEnd = std::min(x1, renderWidth - 1);
+			float* dilatedDepth = currentDilatedDepth->getPlane(0) + static_cast<size_t>(y) * renderWidth;
+			for (; x + FloatV::width <= interiorEnd; x += FloatV::width)
+			{
+				FloatV nearestDepth = FloatV::load(depth + static_cast<size_t>(y) * renderWidth + x);
+				FloatV nearestIndex(-1.0f);
+				for (int i = 0; i < 8; i++)
+				{
+					const float* sample = depth + static_cast<size_t>(y + neighborOffsets[i][1]) * renderWidth + x + neighborOffsets[i][0];
+					const FloatV d = FloatV::load(sample);
+					const MaskV isNearer = lessThan(d, nearestDepth);
+					nearestDepth = select(isNearer, d, nearestDepth);
+					nearestIndex = select(isNearer, FloatV(static_cast<float>(i)), nearestIndex);
+				}
+				nearestDepth.store(dilatedDepth + x);
+
+				float indices[FloatV::width];
+				nearestIndex.store(indices);
+				for (int lane = 0; lane < FloatV::width; lane++)
+				{
+					const int i = static_cast<int>(indices[lane]);
+					const int nearestX = x + lane + (i < 0 ? 0 : neighborOffsets[i][0]);
+					const int nearestY = y + (i < 0 ? 0 : neighborOffsets[i][1]);
+					const float motionVector[2] = { inputMotionVector->fetch(0, nearestX, nearestY), inputMotionVector->fetch(1, nearestX, nearestY) };
+					currentDilatedMotionVector->store(x + lane, y, motionVector);
+				}
+			}
+		}
+		for (; x < x1; x++)
+		{
+			dilatePixel(x, y);
+		}
+	});
+
+	// Copy inputColor -> currentHRColor
+	if (enableInterpolation && !enableSuperResolution)
+	{
+		for (int channel = 0; channel < 4; channel++)
+		{
+			memcpy(currentHRColor->getPlane(channel), inputColor->getPlane(channel), static_cast<size_t>(renderWidth) * renderHeight * sizeof(float));
+		}
+	}
+}
+
+void CpuBackend::upsampleFirstFrame(const UniformBlock& cb)
+{
+	dispatch(presentationWidth, presentationHeight, [&](int y, int x0, int x1)
+	{
+		const float v = (static_cast<float>(y) + 0.5f) * cb.presentation_size.w;
+		const float jitteredV = v + cb.jitter_offset.y * cb.render_size.w;
+		for (int x = x0; x < x1; x++)
+		{
+			const float u = (static_cast<float>(x) + 0.5f) * cb.presentation_size.z;
+			const float jitteredU = u + cb.jitter_offset.x * cb.render_size.z;
+			// Bilinear
+			float color[4];
+			inputColor->sampleLinear(jitteredU, jitteredV, color);
+			currentHRColor->store(x, y, color);
+		}
+	});
+}
+
+void CpuBackend::superSample(const UniformBlock& cb)
+{
+	// Clamps the YCoCg history to the AABB of the 3x3 LR neighborhood
+	auto clampHistoryColorWithAABB = [&](float* historyColor, int posX, int posY)
+	{
+		float color[3];
+		float colorMin[3];
+		float colorMax[3];
+		for (int channel = 0; channel < 3; channel++)
+		{
+			color[channel] = inputColor->fetch(channel, posX, posY);
+		}
+		RGBToYCoCg(color, colorMin);
+		RGBToYCoCg(color, colorMax);
+		for (int i = 0; i < 8; i++)
+		{
+			const int sampleX = clampInt(posX + neighborOffsets[i][0], 0, renderWidth);
+			const int sampleY = clampInt(posY + neighborOffsets[i][1], 0, renderHeight);
+			float sampleColor[3];
+			for (int channel = 0; channel < 3; channel++)
+			{
+				color[channel] = inputColor->fetch(channel, sampleX, sampleY);
+			}
+			RGBToYCoCg(color, sampleColor);
+			for (int channel = 0; channel < 3; channel++)
+			{
+				colorMax[channel] = std::max(colorMax[channel], sampleColor[channel]);
+				colorMin[channel] = std::min(colorMin[channel], sampleColor[channel]);
+			}
+		}
+		float historyColorYCoCg[3];
+		RGBToYCoCg(historyColor, historyColorYCoCg);
+		for (int channel = 0; channel < 3; channel++)
+		{
+			historyColorYCoCg[channel] = std::min(std::max(historyColorYCoCg[channel], colorMin[channel]), colorMax[channel]);
+		}
+		YCoCgToRGB(historyColorYCoCg, historyColor);
+		historyColor[3] = 1.0f;
+	};
+
+	dispatch(presentationWidth, presentationHeight, [&](int y, int x0, int x1)
+	{
+		const float v = (static_cast<float>(y) + 0.5f) * cb.presentation_size.w;
+		const int posY = static_cast<int>(v * cb.render_size.y);
+		for (int x = x0; x < x1; x++)
+		{
+			const float u = (static_cast<float>(x) + 0.5f) * cb.presentation_size.z;
+			const int posX = static_cast<int>(u * cb.render_size.x);
+			const float previousU = u - currentDilatedMotionVector->sampleNearest(0, u, v);
+			const float previousV = v - currentDilatedMotionVector->sampleNearest(1, u, v);
+
+			float historySample[4];
+			sampleWithLut(*previousHRColor, previousU, previousV, cb.presentation_size.x, cb.presentation_size.y, *sampleLut, historySample);
+			clampHistoryColorWithAABB(historySample, posX, posY);
+			const float historyDepth = previousDilatedDepth->sampleNearest(0, previousU, previousV);
+
+			const float jitteredU = u + cb.jitter_offset.x * cb.render_size.z;
+			const float jitteredV = v + cb.jitter_offset.y * cb.render_size.w;
+			float currentSample[4];
+			inputColor->sampleLinear(jitteredU, jitteredV, currentSample);
+			const float currentDepth = currentDilatedDepth->fetch(0, posX, posY);
+			const float depthDiff = std::fabs(currentDepth - historyDepth);
+
+			float resultColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			if (previousU >= 0.0f && previousV >= 0.0f && previousU <= 1.0f && previousV <= 1.0f && depthDiff < cb.depth_diff_threshold_sr)
+			{
+				const float distX = fract(jitteredU * cb.render_size.x) - 0.5f;
+				const float distY = fract(jitteredV * cb.render_size.y) - 0.5f;
+				const float weight = 0.25f - 0.4f * (distX * distX + distY * distY);
+				for (int channel = 0; channel < 3; channel++)
+				{
+					resultColor[channel] = historySample[channel] * (1.0f - weight) + currentSample[channel] * weight;
+				}
+			}
+			else
+			{
+				for (int channel = 0; channel < 3; channel++)
+				{
+					resultColor[channel] = currentSample[channel];
+				}
+			}
+			currentHRColor->store(x, y, resultColor);
+		}
+	});
+}
+
+void CpuBackend::interpolate(const UniformBlock& cb)
+{
+	if (enableGatherReprojection)
+	{
+		reprojectGather(cb);
+	}
+	else
+	{
+		clear(reprojection.get(), invalidReprojection);
+		reproject(cb);
+		fill(reprojection.get(), filledReprojection, enableWideReprojection);
+	}
+	if (enablePushPullFill)
+	{
+		pushPullFill();
+	}
+
+	// ResolveMotion_I
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		for (int x = x0; x < x1; x++)
+		{
+			const uint64_t packedData = filledReprojection[static_cast<size_t>(y) * renderWidth + x];
+			ResolvedMotion& motion = resolvedMotion[static_cast<size_t>(y) * renderWidth + x];
+			int sourceX = -1;
+			int sourceY = -1;
+			if (!isReprojectionValid(packedData))
+			{
+				// Fill with motion vectors from previous frame
+				motion.motionX_t1 = previousDilatedMotionVector->fetch(0, x, y);
+				motion.motionY_t1 = previousDilatedMotionVector->fetch(1, x, y);
+			}
+			else
+			{
+				unpackReprojectionSourcePos(enableWideReprojection, packedData, x, y, sourceX, sourceY);
+				motion.motionX_t1 = currentDilatedMotionVector->fetch(0, sourceX, sourceY);
+				motion.motionY_t1 = currentDilatedMotionVector->fetch(1, sourceX, sourceY);
+			}
+
+			motion.isQuadratic = sourceX != -1 || sourceY != -1;
+			if (motion.isQuadratic)
+			{
+				const float u_t0 = (static_cast<float>(sourceX) + 0.5f) * cb.render_size.z - motion.motionX_t1;
+				const float v_t0 = (static_cast<float>(sourceY) + 0.5f) * cb.render_size.w - motion.motionY_t1;
+				motion.motionX_t0 = previousDilatedMotionVector->sampleNearest(0, u_t0, v_t0);
+				motion.motionY_t0 = previousDilatedMotionVector->sampleNearest(1, u_t0, v_t0);
+			}
+		}
+	});
+
+	// Warp_I
+	dispatch(presentationWidth, presentationHeight, [&](int y, int x0, int x1)
+	{
+		const float v = (static_cast<float>(y) + 0.5f) * cb.presentation_size.w;
+		const int scaledY = static_cast<int>(static_cast<float>(y) / cb.render_scale);
+		for (int x = x0; x < x1; x++)
+		{
+			const float u = (static_cast<float>(x) + 0.5f) * cb.presentation_size.z;
+			const int scaledX = static_cast<int>(static_cast<float>(x) / cb.render_scale);
+			// Zero outside the LR image like texelFetch
+			const ResolvedMotion motion = scaledX < renderWidth && scaledY < renderHeight ? resolvedMotion[static_cast<size_t>(scaledY) * renderWidth + scaledX] : ResolvedMotion{ 0.0f, 0.0f, 0.0f, 0.0f, true };
+
+			float sampleU_t1;
+			float sampleV_t1;
+			float sampleU_t0;
+			float sampleV_t0;
+			if (!motion.isQuadratic)
+			{
+				// Fallback to linear motion estimation
+				sampleU_t1 = u + motion.motionX_t1 * (1.0f - cb.delta.x);
+				sampleV_t1 = v + motion.motionY_t1 * (1.0f - cb.delta.x);
+				sampleU_t0 = u - motion.motionX_t1 * cb.delta.x;
+				sampleV_t0 = v - motion.motionY_t1 * cb.delta.x;
+			}
+			else
+			{
+				// Quadratic motion estimation
+				sampleU_t0 = u + (-cb.delta.y - cb.delta.w) * motion.motionX_t1 + (-cb.delta.y + cb.delta.w) * motion.motionX_t0;
+				sampleV_t0 = v + (-cb.delta.y - cb.delta.w) * motion.motionY_t1 + (-cb.delta.y + cb.delta.w) * motion.motionY_t0;
+				sampleU_t1 = motion.motionX_t1 + sampleU_t0;
+				sampleV_t1 = motion.motionY_t1 + sampleV_t0;
+			}
+
+			float color_t1[4];
+			float color_t0[4];
+			sampleWithLut(*currentHRColor, sampleU_t1, sampleV_t1, cb.presentation_size.x, cb.presentation_size.y, *sampleLut, color_t1);
+			sampleWithLut(*previousHRColor, sampleU_t0, sampleV_t0, cb.presentation_size.x, cb.presentation_size.y, *sampleLut, color_t0);
+			const float depth_t1 = currentDilatedDepth->fetch(0, static_cast<int>(sampleU_t1 * cb.render_size.x), static_cast<int>(sampleV_t1 * cb.render_size.y));
+			const float depth_t0 = previousDilatedDepth->fetch(0, static_cast<int>(sampleU_t0 * cb.render_size.x), static_cast<int>(sampleV_t0 * cb.render_size.y));
+
+			const float* color;
+			float blended[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			const float depthDiff = std::fabs(depth_t0 - depth_t1);
+			if (sampleU_t0 < 0.0f || sampleV_t0 < 0.0f || sampleU_t0 > 1.0f || sampleV_t0 > 1.0f)
+			{
+				color = color_t1;
+			}
+			else if (sampleU_t1 < 0.0f || sampleV_t1 < 0.0f || sampleU_t1 > 1.0f || sampleV_t1 > 1.0f)
+			{
+				color = color_t0;
+			}
+			else if (depthDiff < cb.depth_diff_threshold_fg)
+			{
+				// case 1: both t0 and t1 are valid
+				const float diffR = std::fabs(color_t1[0] - color_t0[0]);
+				const float diffG = std::fabs(color_t1[1] - color_t0[1]);
+				const float diffB = std::fabs(color_t1[2] - color_t0[2]);
+				const float lumaDiff = diffR * 0.5f + (diffB * 0.5f + diffG);
+				if (lumaDiff < cb.color_diff_threshold_fg)
+				{
+					color = cb.delta.x < 0.5f ? color_t0 : color_t1;
+				}
+				else
+				{
+					for (int channel = 0; channel < 3; channel++)
+					{
+						blended[channel] = color_t0[channel] * (1.0f - cb.delta.x) + color_t1[channel] * cb.delta.x;
+					}
+					color = blended;
+				}
+			}
+			else
+			{
+				// case 2: select the one further to the camera (occlusion)
+				color = depth_t1 > depth_t0 ? color_t1 : color_t0;
+			}
+			const float result[4] = { color[0], color[1], color[2], 1.0f };
+			frameGenerationResult->store(x, y, result);
+		}
+	});
+}
+
+void CpuBackend::extrapolate(const UniformBlock& cb)
+{
+	const uint64_t invalid = getInvalidReprojection(false);
+	clear(extrapolationReprojection.get(), invalid);
+
+	// Reproject_E
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		const float v = (static_cast<float>(y) + 0.5f) * cb.render_size.w;
+		for (int x = x0; x < x1; x++)
+		{
+			const float u = (static_cast<float>(x) + 0.5f) * cb.render_size.z;
+			// Linear motion estimation
+			const float deltaU = u + currentDilatedMotionVector->fetch(0, x, y) * cb.delta.x;
+			const float deltaV = v + currentDilatedMotionVector->fetch(1, x, y) * cb.delta.x;
+			if (deltaU < 0.0f || deltaV < 0.0f || deltaU > 1.0f || deltaV > 1.0f)
+			{
+				continue;
+			}
+			const int targetX = static_cast<int>(deltaU * cb.render_size.x);
+			const int targetY = static_cast<int>(deltaV * cb.render_size.y);
+			if (targetX < renderWidth && targetY < renderHeight)
+			{
+				const uint64_t data = packReprojectionData(false, currentDilatedDepth->fetch(0, x, y), x, y, targetX, targetY);
+				atomicMin(extrapolationReprojection[static_cast<size_t>(targetY) * renderWidth + targetX], data);
+			}
+		}
+	});
+
+	fill(extrapolationReprojection.get(), extrapolationFilledReprojection, false);
+
+	// Warp_E
+	dispatch(presentationWidth, presentationHeight, [&](int y, int x0, int x1)
+	{
+		const float v = (static_cast<float>(y) + 0.5f) * cb.presentation_size.w;
+		const int scaledY = static_cast<int>(static_cast<float>(y) / cb.render_scale);
+		for (int x = x0; x < x1; x++)
+		{
+			const float u = (static_cast<float>(x) + 0.5f) * cb.presentation_size.z;
+			const int scaledX = static_cast<int>(static_cast<float>(x) / cb.render_scale);
+			// Zero outside the LR image like texelFetch
+			const uint64_t packedData = scaledX < renderWidth && scaledY < renderHeight ? extrapolationFilledReprojection[static_cast<size_t>(scaledY) * renderWidth + scaledX] : 0;
+
+			float motionX;
+			float motionY;
+			int sourceX = -1;
+			int sourceY = -1;
+			if (packedData == invalid)
+			{
+				const float mvX = currentDilatedMotionVector->fetch(0, scaledX, scaledY);
+				const float mvY = currentDilatedMotionVector->fetch(1, scaledX, scaledY);
+				const int offsetX = static_cast<int>(std::nearbyint(mvX * cb.delta.x * cb.render_size.x));
+				const int offsetY = static_cast<int>(std::nearbyint(mvY * cb.delta.x * cb.render_size.y));
+				const float originDepth = currentDilatedDepth->fetch(0, scaledX, scaledY);
+				// Warp_E.comp offsets the HR position
+				const float sampleDepth = currentDilatedDepth->fetch(0, x - offsetX, y - offsetY);
+				const float threshold = 0.00001f;
+				if (sampleDepth > originDepth - threshold)
+				{
+					// Fill with background pixels
+					motionX = mvX;
+					motionY = mvY;
+				}
+				else
+				{
+					// Not background. Fill with zero
+					motionX = 0.0f;
+					motionY = 0.0f;
+				}
+			}
+			else
+			{
+				unpackReprojectionSourcePos(false, packedData, scaledX, scaledY, sourceX, sourceY);
+				motionX = currentDilatedMotionVector->fetch(0, sourceX, sourceY);
+				motionY = currentDilatedMotionVector->fetch(1, sourceX, sourceY);
+			}
+
+			float sampleU_t1;
+			float sampleV_t1;
+			if (sourceX == -1 && sourceY == -1)
+			{
+				// Fallback to linear motion estimation
+				sampleU_t1 = u - motionX * cb.delta.x;
+				sampleV_t1 = v - motionY * cb.delta.x;
+			}
+			else
+			{
+				// Quadratic motion estimation
+				const float u_t0 = (static_cast<float>(sourceX) + 0.5f) * cb.render_size.z - motionX;
+				const float v_t0 = (static_cast<float>(sourceY) + 0.5f) * cb.render_size.w - motionY;
+				const float motionX_t0 = previousDilatedMotionVector->sampleNearest(0, u_t0, v_t0);
+				const float motionY_t0 = previousDilatedMotionVector->sampleNearest(1, u_t0, v_t0);
+				sampleU_t1 = u + (-cb.delta.z - cb.delta.w) * motionX + (cb.delta.y + cb.delta.w) * motionX_t0;
+				sampleV_t1 = v + (-cb.delta.z - cb.delta.w) * motionY + (cb.delta.y + cb.delta.w) * motionY_t0;
+			}
+
+			float color_t1[4];
+			sampleWithLut(*currentHRColor, sampleU_t1, sampleV_t1, cb.presentation_size.x, cb.presentation_size.y, *sampleLut, color_t1);
+			color_t1[3] = 1.0f;
+			extrapolationResult->store(x, y, color_t1);
+		}
+	});
+}
+
+void CpuBackend::clear(std::atomic<uint64_t>* target, uint64_t invalid)
+{
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		std::atomic<uint64_t>* row = &target[static_cast<size_t>(y) * renderWidth];
+		for (int x = x0; x < x1; x++)
+		{
+			row[x].store(invalid, std::memory_order_relaxed);
+		}
+	});
+}
+
+bool CpuBackend::reprojectPixel(const UniformBlock& cb, int x, int y, int& targetX, int& targetY) const
+{
+	if (x < 0 || y < 0 || x >= renderWidth || y >= renderHeight)
+	{
+		return false;
+	}
+	const float u = (static_cast<float>(x) + 0.5f) * cb.render_size.z;
+	const float v = (static_cast<float>(y) + 0.5f) * cb.render_size.w;
+	const float motionX = currentDilatedMotionVector->fetch(0, x, y);
+	const float motionY = currentDilatedMotionVector->fetch(1, x, y);
+	// Quadratic motion estimation
+	const int x_t0 = static_cast<int>((u - motionX) * cb.render_size.x);
+	const int y_t0 = static_cast<int>((v - motionY) * cb.render_size.y);
+	const float motionX_t0 = previousDilatedMotionVector->fetch(0, x_t0, y_t0);
+	const float motionY_t0 = previousDilatedMotionVector->fetch(1, x_t0, y_t0);
+	const float deltaU = u + (-1.0f + cb.delta.y + cb.delta.w) * motionX + (cb.delta.y - cb.delta.w) * motionX_t0;
+	const float deltaV = v + (-1.0f + cb.delta.y + cb.delta.w) * motionY + (cb.delta.y - cb.delta.w) * motionY_t0;
+	if (deltaU < 0.0f || deltaV < 0.0f || deltaU > 1.0f || deltaV > 1.0f)
+	{
+		return false;
+	}
+	targetX = static_cast<int>(deltaU * cb.render_size.x);
+	targetY = static_cast<int>(deltaV * cb.render_size.y);
+	// Stores outside the image are dropped like image stores
+	return targetX < renderWidth && targetY < renderHeight;
+}
+
+void CpuBackend::reproject(const UniformBlock& cb)
+{
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		for (int x = x0; x < x1; x++)
+		{
+			int targetX;
+			int targetY;
+			if (!reprojectPixel(cb, x, y, targetX, targetY))
+			{
+				continue;
+			}
+			// Store atomic minimum depth and relative position
+			const uint64_t data = packReprojectionData(enableWideReprojection, currentDilatedDepth->fetch(0, x, y), x, y, targetX, targetY);
+			atomicMin(reprojection[static_cast<size_t>(targetY) * renderWidth + targetX], data);
+		}
+	});
+}
+
+void CpuBackend::reprojectGather(const UniformBlock& cb)
+{
+	// ReprojectGather_I: fixed-point search for the source of every target, seeded at and around the target
+	const int seedDistance = 16;
+	const int seedOffsets[5][2] = { { 0, 0 }, { -seedDistance, -seedDistance }, { seedDistance, -seedDistance }, { -seedDistance, seedDistance }, { seedDistance, seedDistance } };
+	const int refinementSteps = 3;
+	// Offset from the center of a source pixel to its reprojected position, in LR pixels
+	auto getOffset = [&](int x, int y, float& offsetX, float& offsetY)
+	{
+		const float u = (static_cast<float>(x) + 0.5f) * cb.render_size.z;
+		const float v = (static_cast<float>(y) + 0.5f) * cb.render_size.w;
+		const float motionX = currentDilatedMotionVector->fetch(0, x, y);
+		const float motionY = currentDilatedMotionVector->fetch(1, x, y);
+		const int x_t0 = static_cast<int>((u - motionX) * cb.render_size.x);
+		const int y_t0 = static_cast<int>((v - motionY) * cb.render_size.y);
+		const float motionX_t0 = previousDilatedMotionVector->fetch(0, x_t0, y_t0);
+		const float motionY_t0 = previousDilatedMotionVector->fetch(1, x_t0, y_t0);
+		offsetX = ((-1.0f + cb.delta.y + cb.delta.w) * motionX + (cb.delta.y - cb.delta.w) * motionX_t0) * cb.render_size.x;
+		offsetY = ((-1.0f + cb.delta.y + cb.delta.w) * motionY + (cb.delta.y - cb.delta.w) * motionY_t0) * cb.render_size.y;
+	};
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		const float targetV = static_cast<float>(y) + 0.5f;
+		for (int x = x0; x < x1; x++)
+		{
+			const float targetU = static_cast<float>(x) + 0.5f;
+			uint64_t hit = invalidReprojection;
+			uint64_t nearHit = invalidReprojection;
+			for (const int* seedOffset : seedOffsets)
+			{
+				float offsetX;
+				float offsetY;
+				getOffset(x + seedOffset[0], y + seedOffset[1], offsetX, offsetY);
+				int sourceX = static_cast<int>(std::floor(targetU - offsetX));
+				int sourceY = static_cast<int>(std::floor(targetV - offsetY));
+				for (int step = 0; step < refinementSteps; step++)
+				{
+					getOffset(sourceX, sourceY, offsetX, offsetY);
+					sourceX = static_cast<int>(std::floor(targetU - offsetX));
+					sourceY = static_cast<int>(std::floor(targetV - offsetY));
+				}
+
+				int reprojectedX;
+				int reprojectedY;
+				if (reprojectPixel(cb, sourceX, sourceY, reprojectedX, reprojectedY) &&
+					std::abs(reprojectedX - x) <= 1 && std::abs(reprojectedY - y) <= 1)
+				{
+					const uint64_t data = packReprojectionData(enableWideReprojection, currentDilatedDepth->fetch(0, sourceX, sourceY), sourceX, sourceY, x, y);
+					if (reprojectedX == x && reprojectedY == y)
+					{
+						hit = std::min(hit, data);
+					}
+					else
+					{
+						nearHit = std::min(nearHit, data);
+					}
+				}
+			}
+			filledReprojection[static_cast<size_t>(y) * renderWidth + x] = isReprojectionValid(hit) ? hit : nearHit;
+		}
+	});
+}
+
+void CpuBackend::fill(const std::atomic<uint64_t>* source, std::vector<uint64_t>& target, bool isWide)
+{
+	// Fill.comp: select the nearest valid neighbor in front of the pixel unless "similar" pixels form a 2x2 square
+	const float fillDepthDiffThreshold = 0.0005f;
+	const uint64_t invalid = getInvalidReprojection(isWide);
+	const unsigned int rejectionMasks[4] =
+	{
+		(1u << 0) | (1u << 1) | (1u << 3) | (1u << 4), // Upper left
+		(1u << 1) | (1u << 2) | (1u << 4) | (1u << 5), // Upper right
+		(1u << 3) | (1u << 4) | (1u << 6) | (1u << 7), // Lower left
+		(1u << 4) | (1u << 5) | (1u << 7) | (1u << 8), // Lower right
+	};
+	dispatch(renderWidth, renderHeight, [&](int y, int x0, int x1)
+	{
+		for (int x = x0; x < x1; x++)
+		{
+			const uint64_t centerData = source[static_cast<size_t>(y) * renderWidth + x].load(std::memory_order_relaxed);
+			const float centerDepth = unpackReprojectionDepth(isWide, centerData);
+			float nearestDepth = 1.0f;
+			uint64_t selectedData = invalid;
+			unsigned int mask = 1u << 4;
+			for (int idx = 0; idx < 9; idx++)
+			{
+				const int neighborX = x + idx / 3 - 1;
+				const int neighborY = y + idx % 3 - 1;
+				if (idx == 4 || neighborX < 0 || neighborY < 0 || neighborX >= renderWidth || neighborY >= renderHeight)
+				{
+					continue;
+				}
+				const uint64_t neighborData = source[static_cast<size_t>(neighborY) * renderWidth + neighborX].load(std::memory_order_relaxed);
+				const float neighborDepth = unpackReprojectionDepth(isWide, neighborData);
+				if (neighborData != invalid && centerDepth - neighborDepth > fillDepthDiffThreshold)
+				{
+					// Select the nearest
+					if (neighborDepth < nearestDepth)
+					{
+						nearestDepth = neighborDepth;
+						selectedData = neighborData;
+					}
+				}
+				else
+				{
+					mask |= 1u << idx;
+				}
+			}
+			bool reject = false;
+			for (int i = 0; i < 4; i++)
+			{
+				reject = reject || (mask & rejectionMasks[i]) == rejectionMasks[i];
+			}
+			uint64_t result = selectedData;
+			if (reject)
+			{
+				result = centerData;
+			}
+			target[static_cast<size_t>(y) * renderWidth + x] = result;
+		}
+	});
+}
+
+void CpuBackend::pushPullFill()
+{
+	// Push: filledReprojection -> level 1 -> ... -> 1x1, minimum of each 2x2 block
+	for (size_t i = 0; i < pushPullLevels.size(); i++)
+	{
+		const std::vector<uint64_t>& fine = i == 0 ? filledReprojection : pushPullLevels[i - 1];
+		const int fineWidth = i == 0 ? renderWidth : pushPullWidths[i - 1];
+		const int fineHeight = i == 0 ? renderHeight : pushPullHeights[i - 1];
+		std::vector<uint64_t>& coarse = pushPullLevels[i];
+		dispatch(pushPullWidths[i], pushPullHeights[i], [&](int y, int x0, int x1)
+		{
+			for (int x = x0; x < x1; x++)
+			{
+				uint64_t result = invalidReprojection;
+				for (int fineY = y * 2; fineY < std::min(y * 2 + 2, fineHeight); fineY++)
+				{
+					for (int fineX = x * 2; fineX < std::min(x * 2 + 2, fineWidth); fineX++)
+					{
+						result = std::min(result, fine[static_cast<size_t>(fineY) * fineWidth + fineX]);
+					}
+				}
+				coarse[static_cast<size_t>(y) * pushPullWidths[i] + x] = result;
+			}
+		});
+	}
+
+	// Pull: 1x1 -> ... -> level 1 -> filledReprojection, only invalid pixels are replaced
+	for (size_t i = pushPullLevels.size(); i > 0; i--)
+	{
+		std::vector<uint64_t>& fine = i == 1 ? filledReprojection : pushPullLevels[i - 2];
+		const int fineWidth = i == 1 ? renderWidth : pushPullWidths[i - 2];
+		const int fineHeight = i == 1 ? renderHeight : pushPullHeights[i - 2];
+		const std::vector<uint64_t>& coarse = pushPullLevels[i - 1];
+		const int coarseWidth = pushPullWidths[i - 1];
+		dispatch(fineWidth, fineHeight, [&](int y, int x0, int x1)
+		{
+			for (int x = x0; x < x1; x++)
+			{
+				uint64_t& data = fine[static_cast<size_t>(y) * fineWidth + x];
+				if (!isReprojectionValid(data))
+				{
+					data = coarse[static_cast<size_t>(y / 2) * coarseWidth + x / 2];
+				}
+			}
+		});
+	}
+}
+
+uint64_t CpuBackend::packReprojectionData(bool isWide, float depth, int sourceX, int sourceY, int targetX, int targetY)
+{
+	if (isWide)
+	{
+		// Depth as float bits in the high word, relative position as 16/16 bits
+		const uint32_t relativeX = static_cast<uint32_t>(clampInt(targetX - sourceX, -32768, 32767) + 32768);
+		const uint32_t relativeY = static_cast<uint32_t>(clampInt(targetY - sourceY, -32768, 32767) + 32768);
+		const float clampedDepth = std::max(depth, 0.0f);
+		uint32_t depthBits;
+		memcpy(&depthBits, &clampedDepth, sizeof(depthBits));
+		return (static_cast<uint64_t>(depthBits) << 32) | (relativeX << 16) | relativeY;
+	}
+	// 11-bit depth, 11/10-bit relative position
+	const uint32_t uDepth = static_cast<uint32_t>(2047.0f * std::max(depth, 0.0f));
+	const uint32_t relativeX = static_cast<uint32_t>(clampInt(targetX - sourceX, -1024, 1023) + 1024);
+	const uint32_t relativeY = static_cast<uint32_t>(clampInt(targetY - sourceY, -512, 511) + 512);
+	return (uDepth << 21) | (relativeX << 10) | relativeY;
+}
+
+float CpuBackend::unpackReprojectionDepth(bool isWide, uint64_t data)
+{
+	if (isWide)
+	{
+		const uint32_t depthBits = static_cast<uint32_t>(data >> 32);
+		if (depthBits == 0xFFFFFFFFu)
+		{
+			return 1.0f;
+		}
+		float depth;
+		memcpy(&depth, &depthBits, sizeof(depth));
+		return depth;
+	}
+	return static_cast<float>((data >> 21) & 0x7FFu) / 2047.0f;
+}
+
+void CpuBackend::unpackReprojectionSourcePos(bool isWide, uint64_t data, int targetX, int targetY, int& sourceX, int& sourceY)
+{
+	if (isWide)
+	{
+		sourceX = targetX - (static_cast<int>((data >> 16) & 0xFFFFu) - 32768);
+		sourceY = targetY - (static_cast<int>(data & 0xFFFFu) - 32768);
+		return;
+	}
+	sourceX = targetX - (static_cast<int>((data >> 10) & 0x7FFu) - 1024);
+	sourceY = targetY - (static_cast<int>(data & 0x3FFu) - 512);
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cpu_image.h"
+#include "thread_pool.h"
+#include "uniform_block.h"
+
+using std::shared_ptr;
+using std::make_shared;
+
+// CPU implementation of the compute shader stages, for machines without a suitable GPU and for validating the
+// OpenGL backend. Every kernel mirrors its .comp file and runs on 2D tiles spread over a work stealing thread pool.
+// Reprojection entries are 64 bit so one code path serves the packed format (low 32 bits) and the wide format
+// (depth bits high, relative position low), with a compare-and-swap minimum in place of imageAtomicMin.
+class CpuBackend
+{
+public:
+	CpuBackend(int renderWidth, int renderHeight, int presentationWidth, int presentationHeight,
+		bool enableSuperResolution, bool enableInterpolation, bool enablePushPullFill, bool enableWideReprojection,
+		bool enableNativeLRColor, bool enableCameraMotionVectors, bool enableSparseMotionVectors, bool enableGatherReprojection,
+		bool enableExtrapolation, int threadCount = 0);
+
+	void loadLUT(const std::string& path);
+
+	// colorPath is the HR color (LR color is sampled from it with super resolution), or the rendered LR color with
+	// enableNativeLRColor
+	void load(const std::string& colorPath, const std::string& depthPath, const std::string& motionVectorXPath, const std::string& motionVectorYPath);
+
+	// Stages, named after OffscreenRenderer
+	void swapBuffers();
+	void processInputs(const UniformBlock& cb, const CameraBlock& camera);
+	void preprocess();
+	void upsampleFirstFrame(const UniformBlock& cb);
+	void superSample(const UniformBlock& cb);
+	void interpolate(const UniformBlock& cb);
+	// Reproject_E / Fill / Warp_E in the packed format with a full fill, like the extrapolation passes the OpenGL
+	// backend times for the pacing simulation
+	void extrapolate(const UniformBlock& cb);
+
+	shared_ptr<CpuImage> getCurrentHRColor() const { return currentHRColor; }
+
+	shared_ptr<CpuImage> getPreviousHRColor() const { return previousHRColor; }
+
+	shared_ptr<CpuImage> getFrameGenerationResult() const { return frameGenerationResult; }
+
+	shared_ptr<CpuImage> getExtrapolationResult() const { return extrapolationResult; }
+
+	int getThreadCount() const { return threadPool.getThreadCount(); }
+private:
+	int renderWidth;
+	int renderHeight;
+	int presentationWidth;
+	int presentationHeight;
+	bool enableSuperResolution;
+	bool enableInterpolation;
+	bool enablePushPullFill;
+	bool enableWideReprojection;
+	bool enableNativeLRColor;
+	bool enableCameraMotionVectors;
+	bool enableSparseMotionVectors;
+	bool enableGatherReprojection;
+	bool enableExtrapolation;
+	uint64_t invalidReprojection;
+
+	// ResolveMotion_I output, motion of t1 and t0 per LR pixel
+	struct ResolvedMotion
+	{
+		float motionX_t1;
+		float motionY_t1;
+		float motionX_t0;
+		float motionY_t0;
+		bool isQuadratic;
+	};
+
+	ThreadPool threadPool;
+
+	// Raw inputs
+	shared_ptr<CpuImage> rawInputHRColor;
+	shared_ptr<CpuImage> rawInputDepth;
+	shared_ptr<CpuImage> rawInputMotionVectorX;
+	shared_ptr<CpuImage> rawInputMotionVectorY;
+
+	// Inputs
+	shared_ptr<CpuImage> inputColor;
+	shared_ptr<CpuImage> inputDepth;
+	shared_ptr<CpuImage> inputMotionVector;
+
+	// LUTs
+	shared_ptr<CpuImage> sampleLut;
+
+	// Current
+	shared_ptr<CpuImage> currentDilatedDepth;
+	shared_ptr<CpuImage> currentDilatedMotionVector;
+	shared_ptr<CpuImage> currentHRColor;
+
+	// Previous
+	shared_ptr<CpuImage> previousDilatedDepth;
+	shared_ptr<CpuImage> previousDilatedMotionVector;
+	shared_ptr<CpuImage> previousHRColor;
+
+	// Frame generation
+	std::unique_ptr<std::atomic<uint64_t>[]> reprojection;
+	std::vector<uint64_t> filledReprojection;
+	std::vector<ResolvedMotion> resolvedMotion;
+	shared_ptr<CpuImage> frameGenerationResult;
+
+	// Extrapolation, always packed
+	std::unique_ptr<std::atomic<uint64_t>[]> extrapolationReprojection;
+	std::vector<uint64_t> extrapolationFilledReprojection;
+	shared_ptr<CpuImage> extrapolationResult;
+
+	// Push-pull fill (level 0 is filledReprojection)
+	std::vector<std::vector<uint64_t>> pushPullLevels;
+	std::vector<int> pushPullWidths;
+	std::vector<int> pushPullHeights;
+
+	// Calls kernel(y, x0, x1) for every row of every tile of a width x height grid
+	void dispatch(int width, int height, const std::function<void(int, int, int)>& kernel);
+
+	void decodeMotionVectors();
+	void reconstructMotionVectors(const UniformBlock& cb, const CameraBlock& camera);
+	void clear(std::atomic<uint64_t>* target, uint64_t invalid);
+	// False if the pixel is outside the image or reprojected outside the image
+	bool reprojectPixel(const UniformBlock& cb, int x, int y, int& targetX, int& targetY) const;
+	void reproject(const UniformBlock& cb);
+	void reprojectGather(const UniformBlock& cb);
+	void fill(const std::atomic<uint64_t>* source, std::vector<uint64_t>& target, bool isWide);
+	void pushPullFill();
+
+	// isWide selects the wide format, else the packed one
+	static uint64_t getInvalidReprojection(bool isWide) { return isWide ? ~0ull : 0xFFFFFFFFull; }
+	static uint64_t packReprojectionData(bool isWide, float depth, int sourceX, int sourceY, int targetX, int targetY);
+	static float unpackReprojectionDepth(bool isWide, uint64_t data);
+	static void unpackReprojectionSourcePos(bool isWide, uint64_t data, int targetX, int targetY, int& sourceX, int& sourceY);
+	bool isReprojectionValid(uint64_t data) const { return data != invalidReprojection; }
+};
@@ -0,0 +1,232 @@
+#include "cpu_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include "tinyexr.h"
+
+static int getChannelCount(CpuImageFormat format)
+{
+	switch (format)
+	{
+	case CpuImageFormat::RGBA8:
+		return 4;
+	case CpuImageFormat::RG16F:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+// Half float rounded toward zero, as 16-bit float formats are stored by Mesa (GL leaves the rounding of these
+// conversions to the implementation). A rounding that differs in the last bit moves motion vectors across texel
+// boundaries of the nearest lookups and flips history and reprojection decisions
+static float roundToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = bits & 0x80000000u;
+	uint32_t magnitude = bits & 0x7FFFFFFFu;
+	if (magnitude >= 0x7F800000u)
+	{
+		// Inf, NaN
+		return value;
+	}
+	if (magnitude < 0x38800000u)
+	{
+		// Half denormals are multiples of 2^-24
+		return std::trunc(value * 16777216.0f) / 16777216.0f;
+	}
+	magnitude &= ~0x1FFFu;
+	if (magnitude > 0x477FE000u)
+	{
+		magnitude = 0x477FE000u;
+	}
+	bits = sign | magnitude;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// 8-bit unorm to float the way texel fetches convert it, a multiplication by 1/255 (one ulp off c / 255 for some c)
+static float unormToFloat(int value)
+{
+	return static_cast<float>(value) * (1.0f / 255.0f);
+}
+
+CpuImage::CpuImage(CpuImageFormat format, int width, int height) :
+	format(format), width(width), height(height), channels(getChannelCount(format)),
+	data(static_cast<size_t>(getChannelCount(format)) * width * height, 0.0f)
+{
+}
+
+void CpuImage::loadFromFile(const std::string& path)
+{
+	int w, h, c;
+	unsigned char* pixels = stbi_load(path.c_str(), &w, &h, &c, 0);
+	if (!pixels)
+	{
+		std::cout << "Failed to load texture " << path << std::endl;
+		return;
+	}
+	const int rowCount = std::min(h, height);
+	const int columnCount = std::min(w, width);
+	for (int channel = 0; channel < channels; channel++)
+	{
+		const float missing = channel == 3 ? 1.0f : 0.0f;
+		for (int y = 0; y < rowCount; y++)
+		{
+			float* row = getPlane(channel) + static_cast<size_t>(y) * width;
+			const unsigned char* source = pixels + static_cast<size_t>(y) * w * c;
+			for (int x = 0; x < columnCount; x++)
+			{
+				row[x] = channel < c ? unormToFloat(source[x * c + channel]) : missing;
+			}
+		}
+	}
+	stbi_image_free(pixels);
+}
+
+void CpuImage::loadLUT(const std::string& path)
+{
+	int w, h;
+	float* pixels;
+	const char* err;
+	int ret = LoadEXR(&pixels, &w, &h, path.c_str(), &err);
+	if (ret < 0)
+	{
+		std::cerr << err << "\n";
+		return;
+	}
+	// RGBA -> A
+	for (int y = 0; y < std::min(h, height); y++)
+	{
+		for (int x = 0; x < std::min(w, width); x++)
+		{
+			const float value = pixels[(static_cast<size_t>(y) * w + x) * 4 + 3];
+			store(x, y, &value);
+		}
+	}
+	free(pixels);
+}
+
+float CpuImage::sampleNearest(int channel, float u, float v) const
+{
+	const int x = std::min(std::max(static_cast<int>(std::floor(u * width)), 0), width - 1);
+	const int y = std::min(std::max(static_cast<int>(std::floor(v * height)), 0), height - 1);
+	return data[(static_cast<size_t>(channel) * height + y) * width + x];
+}
+
+void CpuImage::sampleLinear(float u, float v, float* result) const
+{
+	if (format == CpuImageFormat::RGBA8)
+	{
+		// 8-bit fixed point like the texture units: weights with 8 fractional bits, every lerp rounded to 8 bits
+		const int fx = static_cast<int>(std::nearbyint(u * width * 256.0f - 128.0f));
+		const int fy = static_cast<int>(std::nearbyint(v * height * 256.0f - 128.0f));
+		const int ax = fx & 255;
+		const int ay = fy & 255;
+		const int x0 = std::min(std::max(fx >> 8, 0), width - 1);
+		const int y0 = std::min(std::max(fy >> 8, 0), height - 1);
+		const int x1 = std::min(std::max((fx >> 8) + 1, 0), width - 1);
+		const int y1 = std::min(std::max((fy >> 8) + 1, 0), height - 1);
+		auto lerp = [](int a, int b, int weight) { return (a * 256 + (b - a) * weight + 128) >> 8; };
+		for (int channel = 0; channel < channels; channel++)
+		{
+			const float* plane = getPlane(channel);
+			const float* row0 = plane + static_cast<size_t>(y0) * width;
+			const float* row1 = plane + static_cast<size_t>(y1) * width;
+			auto toByte = [](float value) { return static_cast<int>(value * 255.0f + 0.5f); };
+			const int top = lerp(toByte(row0[x0]), toByte(row0[x1]), ax);
+			const int bottom = lerp(toByte(row1[x0]), toByte(row1[x1]), ax);
+			result[channel] = unormToFloat(lerp(top, bottom, ay));
+		}
+		return;
+	}
+
+	const float fx = u * width - 0.5f;
+	const float fy = v * height - 0.5f;
+	const float floorX = std::floor(fx);
+	const float floorY = std::floor(fy);
+	const float ax = fx - floorX;
+	const float ay = fy - floorY;
+	const int x0 = std::min(std::max(static_cast<int>(floorX), 0), width - 1);
+	const int y0 = std::min(std::max(static_cast<int>(floorY), 0), height - 1);
+	const int x1 = std::min(std::max(static_cast<int>(floorX) + 1, 0), width - 1);
+	const int y1 = std::min(std::max(static_cast<int>(floorY) + 1, 0), height - 1);
+	for (int channel = 0; channel < channels; channel++)
+	{
+		const float* plane = getPlane(channel);
+		const float* row0 = plane + static_cast<size_t>(y0) * width;
+		const float* row1 = plane + static_cast<size_t>(y1) * width;
+		const float top = row0[x0] + (row0[x1] - row0[x0]) * ax;
+		const float bottom = row1[x0] + (row1[x1] - row1[x0]) * ax;
+		result[channel] = top + (bottom - top) * ay;
+	}
+}
+
+void CpuImage::store(int x, int y, const float* values)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+	{
+		return;
+	}
+	for (int channel = 0; channel < channels; channel++)
+	{
+		data[(static_cast<size_t>(channel) * height + y) * width + x] = quantize(values[channel]);
+	}
+}
+
+void CpuImage::quantizeRow(int channel, int y, int x0, int x1)
+{
+	if (format == CpuImageFormat::R32F)
+	{
+		return;
+	}
+	float* row = getPlane(channel) + static_cast<size_t>(y) * width;
+	for (int x = x0; x < x1; x++)
+	{
+		row[x] = quantize(row[x]);
+	}
+}
+
+void CpuImage::getRGBA8(std::vector<unsigned char>& result) const
+{
+	const size_t pixelCount = static_cast<size_t>(width) * height;
+	result.resize(pixelCount * 4);
+	for (int channel = 0; channel < 4; channel++)
+	{
+		const float* plane = channel < channels ? getPlane(channel) : nullptr;
+		const float missing = channel == 3 ? 1.0f : 0.0f;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			const float value = plane ? plane[i] : missing;
+			result[i * 4 + channel] = static_cast<unsigned char>(std::floor((value > 0.0f ? std::min(value, 1.0f) : 0.0f) * 255.0f + 0.5f));
+		}
+	}
+}
+
+void CpuImage::saveAsPNG(const char* path) const
+{
+	std::vector<unsigned char> pixels;
+	getRGBA8(pixels);
+	stbi_write_png(path, width, height, 4, pixels.data(), 0);
+}
+
+float CpuImage::quantize(float value) const
+{
+	switch (format)
+	{
+	case CpuImageFormat::RGBA8:
+		// NaN -> 0
+		return unormToFloat(static_cast<int>(std::floor((value > 0.0f ? std::min(value, 1.0f) : 0.0f) * 255.0f + 0.5f)));
+	case CpuImageFormat::RG16F:
+	case CpuImageFormat::R16F:
+		return roundToHalf(value);
+	default:
+		return value;
+	}
+}
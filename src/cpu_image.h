@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Storage formats of the textures the CPU backend stands in for. Values are kept as floats and rounded to the
+// precision of the format when stored, so results match the OpenGL backend up to arithmetic differences.
+enum class CpuImageFormat
+{
+	RGBA8,
+	R32F,
+	RG16F,
+	R16F,
+};
+
+// Image of the CPU backend, one float plane per channel (structure of arrays). Accessors follow GLSL: fetch() is
+// texelFetch (0 outside the image), sampleNearest()/sampleLinear() are texture() with clamp to edge.
+class CpuImage
+{
+public:
+	CpuImage(CpuImageFormat format, int width, int height);
+
+	// Missing channels of the file are 0, alpha is 1 (like uploading GL_RGB)
+	void loadFromFile(const std::string& path);
+
+	// Alpha channel of an EXR file into a single channel image
+	void loadLUT(const std::string& path);
+
+	int getWidth() const { return width; }
+
+	int getHeight() const { return height; }
+
+	int getChannels() const { return channels; }
+
+	float* getPlane(int channel) { return &data[static_cast<size_t>(channel) * width * height]; }
+
+	const float* getPlane(int channel) const { return &data[static_cast<size_t>(channel) * width * height]; }
+
+	float fetch(int channel, int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= width || y >= height)
+		{
+			return 0.0f;
+		}
+		return data[(static_cast<size_t>(channel) * height + y) * width + x];
+	}
+
+	float sampleNearest(int channel, float u, float v) const;
+
+	// All channels into result[0..channels)
+	void sampleLinear(float u, float v, float* result) const;
+
+	// Rounds values[0..channels) to the format
+	void store(int x, int y, const float* values);
+
+	// Rounds [x0, x1) of a row to the format, for kernels that write planes directly
+	void quantizeRow(int channel, int y, int x0, int x1);
+
+	// RGBA, 8 bits per channel, row major
+	void getRGBA8(std::vector<unsigned char>& result) const;
+
+	void saveAsPNG(const char* path) const;
+private:
+	CpuImageFormat format;
+	int width;
+	int height;
+	int channels;
+	std::vector<float> data;
+
+	float quantize(float value) const;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+// Float vectors of the widest instruction set enabled at compile time: AVX2 (8 lanes, ENABLE_AVX2 in CMake),
+// SSE2 (4 lanes, baseline of x86-64) or scalar code (1 lane). Kernels process FloatV::width pixels per step and
+// finish rows with the scalar path.
+#if defined(__AVX2__)
+#define CPU_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPU_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(CPU_SIMD_AVX2)
+
+struct FloatV
+{
+	static const int width = 8;
+	__m256 v;
+
+	FloatV() {}
+	FloatV(__m256 v) : v(v) {}
+	FloatV(float f) : v(_mm256_set1_ps(f)) {}
+
+	static FloatV load(const float* p) { return _mm256_loadu_ps(p); }
+	void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+
+typedef FloatV MaskV;
+
+inline FloatV operator+(FloatV a, FloatV b) { return _mm256_add_ps(a.v, b.v); }
+inline FloatV operator-(FloatV a, FloatV b) { return _mm256_sub_ps(a.v, b.v); }
+inline FloatV operator*(FloatV a, FloatV b) { return _mm256_mul_ps(a.v, b.v); }
+inline FloatV min(FloatV a, FloatV b) { return _mm256_min_ps(a.v, b.v); }
+inline FloatV max(FloatV a, FloatV b) { return _mm256_max_ps(a.v, b.v); }
+inline MaskV lessThan(FloatV a, FloatV b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+// mask ? a : b per lane
+inline FloatV select(MaskV mask, FloatV a, FloatV b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+
+#elif defined(CPU_SIMD_SSE2)
+
+struct FloatV
+{
+	static const int width = 4;
+	__m128 v;
+
+	FloatV() {}
+	FloatV(__m128 v) : v(v) {}
+	FloatV(float f) : v(_mm_set1_ps(f)) {}
+
+	static FloatV load(const float* p) { return _mm_loadu_ps(p); }
+	void store(float* p) const { _mm_storeu_ps(p, v); }
+};
+
+typedef FloatV MaskV;
+
+inline FloatV operator+(FloatV a, FloatV b) { return _mm_add_ps(a.v, b.v); }
+inline FloatV operator-(FloatV a, FloatV b) { return _mm_sub_ps(a.v, b.v); }
+inline FloatV operator*(FloatV a, FloatV b) { return _mm_mul_ps(a.v, b.v); }
+inline FloatV min(FloatV a, FloatV b) { return _mm_min_ps(a.v, b.v); }
+inline FloatV max(FloatV a, FloatV b) { return _mm_max_ps(a.v, b.v); }
+inline MaskV lessThan(FloatV a, FloatV b) { return _mm_cmplt_ps(a.v, b.v); }
+// mask ? a : b per lane
+inline FloatV select(MaskV mask, FloatV a, FloatV b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+
+#else
+
+struct FloatV
+{
+	static const int width = 1;
+	float v;
+
+	FloatV() {}
+	FloatV(float f) : v(f) {}
+
+	static FloatV load(const float* p) { return *p; }
+	void store(float* p) const { *p = v; }
+};
+
+struct MaskV
+{
+	bool v;
+};
+
+inline FloatV operator+(FloatV a, FloatV b) { return a.v + b.v; }
+inline FloatV operator-(FloatV a, FloatV b) { return a.v - b.v; }
+inline FloatV operator*(FloatV a, FloatV b) { return a.v * b.v; }
+inline FloatV min(FloatV a, FloatV b) { return b.v < a.v ? b.v : a.v; }
+inline FloatV max(FloatV a, FloatV b) { return a.v < b.v ? b.v : a.v; }
+inline MaskV lessThan(FloatV a, FloatV b) { MaskV mask; mask.v = a.v < b.v; return mask; }
+// mask ? a : b per lane
+inline FloatV select(MaskV mask, FloatV a, FloatV b) { return mask.v ? a : b; }
+
+#endif
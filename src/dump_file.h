@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+// Intermediate texture written by OffscreenRenderer for dumpResources: a DumpHeader followed by width x height texels
+// in glReadPixels order (first row is y = 0), channels interleaved. Read by tools/decode_dump.cpp.
+const char dumpMagic[4] = { 'M', 'F', 'G', 'D' };
+const uint32_t dumpVersion = 1;
+
+enum class DumpComponentType : uint32_t
+{
+	UInt8,
+	UInt32,
+	Float32     // Also 16-bit float textures, widened exactly
+};
+
+struct DumpHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t channels;
+	uint32_t componentType;     // DumpComponentType
+	uint32_t glFormat;          // Internal format of the texture, tells the packed (GL_R32UI) and wide reprojection apart
+	int32_t frame;              // Output frame
+	char name[32];              // Resource name, as in dumpResources
+};
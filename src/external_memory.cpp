@@ -0,0 +1,120 @@
+#include "external_memory.h"
+
+#include <cstring>
+#include <iostream>
+
+// GL_EXT_memory_object and GL_EXT_memory_object_fd, not part of the generated glad
+#define GL_TEXTURE_TILING_EXT               0x9580
+#define GL_DEDICATED_MEMORY_OBJECT_EXT      0x9581
+#define GL_OPTIMAL_TILING_EXT               0x9584
+#define GL_LINEAR_TILING_EXT                0x9585
+#define GL_HANDLE_TYPE_OPAQUE_FD_EXT        0x9586
+
+typedef void (APIENTRYP PFNGLCREATEMEMORYOBJECTSEXTPROC)(GLsizei n, GLuint* memoryObjects);
+typedef void (APIENTRYP PFNGLDELETEMEMORYOBJECTSEXTPROC)(GLsizei n, const GLuint* memoryObjects);
+typedef void (APIENTRYP PFNGLMEMORYOBJECTPARAMETERIVEXTPROC)(GLuint memoryObject, GLenum pname, const GLint* params);
+typedef void (APIENTRYP PFNGLIMPORTMEMORYFDEXTPROC)(GLuint memory, GLuint64 size, GLenum handleType, GLint fd);
+typedef void (APIENTRYP PFNGLTEXSTORAGEMEM2DEXTPROC)(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width,
+	GLsizei height, GLuint memory, GLuint64 offset);
+
+static PFNGLCREATEMEMORYOBJECTSEXTPROC createMemoryObjects = nullptr;
+static PFNGLDELETEMEMORYOBJECTSEXTPROC deleteMemoryObjects = nullptr;
+static PFNGLMEMORYOBJECTPARAMETERIVEXTPROC memoryObjectParameteriv = nullptr;
+static PFNGLIMPORTMEMORYFDEXTPROC importMemoryFd = nullptr;
+static PFNGLTEXSTORAGEMEM2DEXTPROC texStorageMem2D = nullptr;
+
+bool ExternalMemory::loadFunctions(void* (*getProcAddress)(const char*))
+{
+	bool hasExtension = false;
+	GLint extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+	for (GLint i = 0; i < extensionCount; i++)
+	{
+		const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		hasExtension = hasExtension || (extension && strcmp(extension, "GL_EXT_memory_object_fd") == 0);
+	}
+	if (!hasExtension)
+	{
+		return false;
+	}
+	createMemoryObjects = reinterpret_cast<PFNGLCREATEMEMORYOBJECTSEXTPROC>(getProcAddress("glCreateMemoryObjectsEXT"));
+	deleteMemoryObjects = reinterpret_cast<PFNGLDELETEMEMORYOBJECTSEXTPROC>(getProcAddress("glDeleteMemoryObjectsEXT"));
+	memoryObjectParameteriv = reinterpret_cast<PFNGLMEMORYOBJECTPARAMETERIVEXTPROC>(getProcAddress("glMemoryObjectParameterivEXT"));
+	importMemoryFd = reinterpret_cast<PFNGLIMPORTMEMORYFDEXTPROC>(getProcAddress("glImportMemoryFdEXT"));
+	texStorageMem2D = reinterpret_cast<PFNGLTEXSTORAGEMEM2DEXTPROC>(getProcAddress("glTexStorageMem2DEXT"));
+	return createMemoryObjects && deleteMemoryObjects && memoryObjectParameteriv && importMemoryFd && texStorageMem2D;
+}
+
+ExternalMemory::ExternalMemory(int fd, GLuint64 size, bool dedicated) :
+	memoryObject(0)
+{
+	if (!importMemoryFd)
+	{
+		std::cout << "ERROR: GL_EXT_memory_object_fd is not loaded" << std::endl;
+		return;
+	}
+	while (glGetError() != GL_NO_ERROR)
+	{
+	}
+	createMemoryObjects(1, &memoryObject);
+	const GLint isDedicated = dedicated ? GL_TRUE : GL_FALSE;
+	memoryObjectParameteriv(memoryObject, GL_DEDICATED_MEMORY_OBJECT_EXT, &isDedicated);
+	importMemoryFd(memoryObject, size, GL_HANDLE_TYPE_OPAQUE_FD_EXT, fd);
+	const GLenum error = glGetError();
+	if (error != GL_NO_ERROR)
+	{
+		std::cout << "ERROR: Importing memory of fd " << fd << " failed (0x" << std::hex << error << std::dec << ")" << std::endl;
+		deleteMemoryObjects(1, &memoryObject);
+		memoryObject = 0;
+	}
+}
+
+ExternalMemory::~ExternalMemory()
+{
+	if (!textures.empty())
+	{
+		glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+	}
+	if (memoryObject)
+	{
+		deleteMemoryObjects(1, &memoryObject);
+	}
+}
+
+GLuint ExternalMemory::createTexture(GLenum format, GLsizei width, GLsizei height, GLuint64 offset, bool linearTiling)
+{
+	if (!memoryObject)
+	{
+		return 0;
+	}
+	while (glGetError() != GL_NO_ERROR)
+	{
+	}
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_TILING_EXT, linearTiling ? GL_LINEAR_TILING_EXT : GL_OPTIMAL_TILING_EXT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	texStorageMem2D(GL_TEXTURE_2D, 1, format, width, height, memoryObject, offset);
+	// Some drivers only import memory of their own Vulkan driver and leave the texture empty without an error
+	GLint importedWidth = 0;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &importedWidth);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	GLenum error = glGetError();
+	if (error == GL_NO_ERROR && importedWidth != width)
+	{
+		error = GL_INVALID_OPERATION;
+	}
+	if (error != GL_NO_ERROR)
+	{
+		std::cout << "ERROR: " << width << "x" << height << " texture at offset " << offset << " of imported memory failed (0x"
+			<< std::hex << error << std::dec << ")" << std::endl;
+		glDeleteTextures(1, &texture);
+		return 0;
+	}
+	textures.push_back(texture);
+	return texture;
+}
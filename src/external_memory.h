@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include <glad/glad.h>
+
+// Memory allocated by another API in the same process (e.g. a Vulkan device exporting VkDeviceMemory as an opaque file
+// descriptor), imported through GL_EXT_memory_object_fd so its images can be used as textures without copies. The
+// exporting API synchronizes its writes before OpenGL reads them (fences or GL_EXT_semaphore_fd).
+class ExternalMemory
+{
+public:
+	// Loads the entry points through getProcAddress, false if GL_EXT_memory_object_fd is not supported
+	static bool loadFunctions(void* (*getProcAddress)(const char*));
+
+	// Imports size bytes of fd, which belongs to OpenGL afterwards. dedicated if the allocation is dedicated to one
+	// image (VkMemoryDedicatedAllocateInfo). isValid() false with an ERROR message if the import failed
+	ExternalMemory(int fd, GLuint64 size, bool dedicated);
+
+	// Deletes the textures created in the memory, then the memory object
+	~ExternalMemory();
+
+	bool isValid() const { return memoryObject != 0; }
+
+	// 2D texture with one level at offset, in the layout of an image created with VK_IMAGE_TILING_OPTIMAL or with
+	// linearTiling VK_IMAGE_TILING_LINEAR. 0 with an ERROR message if it cannot be created
+	GLuint createTexture(GLenum format, GLsizei width, GLsizei height, GLuint64 offset, bool linearTiling);
+private:
+	GLuint memoryObject;
+	std::vector<GLuint> textures;
+};
@@ -0,0 +1,326 @@
+#include "frame_server.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Segment of size bytes, created empty (an existing segment of the name is replaced)
+static unsigned char* createSegment(const std::string& name, size_t size)
+{
+	shm_unlink(name.c_str());
+	const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+	void* data = ftruncate(fd, static_cast<off_t>(size)) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		shm_unlink(name.c_str());
+		return nullptr;
+	}
+	return static_cast<unsigned char*>(data);
+}
+
+// False if the connection closed or failed before size bytes
+static bool receiveAll(int connection, void* data, size_t size)
+{
+	unsigned char* bytes = static_cast<unsigned char*>(data);
+	while (size > 0)
+	{
+		const ssize_t count = recv(connection, bytes, size, 0);
+		if (count < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (count <= 0)
+		{
+			return false;
+		}
+		bytes += count;
+		size -= static_cast<size_t>(count);
+	}
+	return true;
+}
+
+static bool sendAll(int connection, const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	while (size > 0)
+	{
+		const ssize_t count = send(connection, bytes, size, MSG_NOSIGNAL);
+		if (count < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (count <= 0)
+		{
+			return false;
+		}
+		bytes += count;
+		size -= static_cast<size_t>(count);
+	}
+	return true;
+}
+
+FrameServer::FrameServer(const std::string& socketPath, const Options& baseOptions) :
+	socketPath(socketPath), baseOptions(baseOptions), colorIndex(0), segmentCount(0), input(nullptr), output(nullptr),
+	inputSize(0), outputSize(0), slotCount(0), nextSlot(0), outputFrame(0)
+{
+}
+
+FrameServer::~FrameServer()
+{
+	closeSegments();
+}
+
+bool FrameServer::run()
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path))
+	{
+		std::cout << "ERROR: Socket path " << socketPath << " is longer than " << sizeof(address.sun_path) - 1 << " characters" << std::endl;
+		return false;
+	}
+	strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+	const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(socketPath.c_str());
+	if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 1) != 0)
+	{
+		std::cout << "ERROR: Cannot listen on " << socketPath << ": " << strerror(errno) << std::endl;
+		if (listener >= 0)
+		{
+			close(listener);
+		}
+		return false;
+	}
+	std::cout << "Frame server listening on " << socketPath << std::endl;
+
+	bool isRunning = true;
+	while (isRunning)
+	{
+		const int connection = accept(listener, nullptr, nullptr);
+		if (connection < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			std::cout << "ERROR: accept failed: " << strerror(errno) << std::endl;
+			break;
+		}
+		FrameServerRequest request;
+		while (isRunning && receiveAll(connection, &request, sizeof(request)))
+		{
+			FrameServerResponse response;
+			memset(&response, 0, sizeof(response));
+			memcpy(response.magic, frameServerMagic, sizeof(frameServerMagic));
+			std::string error;
+			const FrameServerRequestType type = static_cast<FrameServerRequestType>(request.type);
+			if (memcmp(request.magic, frameServerMagic, sizeof(frameServerMagic)) != 0 || request.version != frameServerVersion)
+			{
+				error = "Not a frame server request of version " + std::to_string(frameServerVersion);
+			}
+			else if (type == FrameServerRequestType::Open)
+			{
+				error = open(request, response);
+			}
+			else if (type == FrameServerRequestType::Submit)
+			{
+				error = submit(response);
+			}
+			else if (type == FrameServerRequestType::Close)
+			{
+				closeSegments();
+			}
+			else if (type == FrameServerRequestType::Shutdown)
+			{
+				isRunning = false;
+			}
+			else
+			{
+				error = "Unknown request type " + std::to_string(request.type);
+			}
+			if (!error.empty())
+			{
+				response.status = 1;
+				strncpy(response.message, error.c_str(), sizeof(response.message) - 1);
+			}
+			if (!sendAll(connection, &response, sizeof(response)))
+			{
+				break;
+			}
+		}
+		// Segments of a lost client are not reused
+		closeSegments();
+		close(connection);
+	}
+	close(listener);
+	unlink(socketPath.c_str());
+	return true;
+}
+
+std::string FrameServer::open(const FrameServerRequest& request, FrameServerResponse& response)
+{
+	closeSegments();
+
+	Options options = baseOptions;
+	const std::string lines(request.options, strnlen(request.options, sizeof(request.options)));
+	size_t begin = 0;
+	for (int lineNumber = 1; begin < lines.size(); lineNumber++)
+	{
+		size_t end = lines.find('\n', begin);
+		end = end == std::string::npos ? lines.size() : end;
+		const std::string line = lines.substr(begin, end - begin);
+		begin = end + 1;
+		// Blank lines are skipped, like in loadOptions()
+		if (line.find_first_not_of(" \t\r") == std::string::npos)
+		{
+			continue;
+		}
+		std::pair<std::string, std::string> option;
+		if (!parseOption(line, option))
+		{
+			return "Expected \"name=value\" in options line " + std::to_string(lineNumber);
+		}
+		options.push_back(option);
+	}
+	if (!renderer || options != rendererOptions)
+	{
+		// Programs are compiled again only for a different configuration
+		renderer = nullptr;
+		colors[0] = colors[1] = depth = motionVector = nullptr;
+		rendererOptions.clear();
+		shared_ptr<OffscreenRenderer> configured = make_shared<OffscreenRenderer>(options, true);
+		if (!configured->isConfigured())
+		{
+			return "Invalid options, see the server output";
+		}
+		renderer = configured;
+		rendererOptions = options;
+		const int w = renderer->getRenderWidth();
+		const int h = renderer->getRenderHeight();
+		colors[0] = make_shared<Texture>(GL_RGBA8, w, h, GL_LINEAR);
+		colors[1] = make_shared<Texture>(GL_RGBA8, w, h, GL_LINEAR);
+		depth = make_shared<Texture>(GL_R32F, w, h, GL_NEAREST);
+		motionVector = make_shared<Texture>(GL_RG32F, w, h, GL_NEAREST);
+	}
+	if (!renderer->beginFrames())
+	{
+		return "Cannot run submitted frames, see the server output";
+	}
+
+	response.renderWidth = static_cast<uint32_t>(renderer->getRenderWidth());
+	response.renderHeight = static_cast<uint32_t>(renderer->getRenderHeight());
+	response.presentationWidth = static_cast<uint32_t>(renderer->getPresentationWidth());
+	response.presentationHeight = static_cast<uint32_t>(renderer->getPresentationHeight());
+	// Outputs of two frames, the client can read one frame while the next one runs
+	slotCount = static_cast<uint32_t>(renderer->getCycleLength()) * 2;
+	response.slotCount = slotCount;
+	const std::string prefix = "/mobfgsr-" + std::to_string(getpid()) + "-" + std::to_string(segmentCount++);
+	inputSegment = prefix + "-input";
+	outputSegment = prefix + "-output";
+	inputSize = getInputSegmentSize(response.renderWidth, response.renderHeight);
+	outputSize = getOutputSlotSize(response.presentationWidth, response.presentationHeight) * slotCount;
+	input = createSegment(inputSegment, inputSize);
+	output = createSegment(outputSegment, outputSize);
+	if (!input || !output)
+	{
+		const std::string error = std::string("Cannot create shared memory: ") + strerror(errno);
+		closeSegments();
+		return error;
+	}
+	strncpy(response.inputSegment, inputSegment.c_str(), sizeof(response.inputSegment) - 1);
+	strncpy(response.outputSegment, outputSegment.c_str(), sizeof(response.outputSegment) - 1);
+	nextSlot = 0;
+	outputFrame = 0;
+	return "";
+}
+
+std::string FrameServer::submit(FrameServerResponse& response)
+{
+	if (!input)
+	{
+		return "Submit before Open";
+	}
+	const uint32_t w = static_cast<uint32_t>(renderer->getRenderWidth());
+	const uint32_t h = static_cast<uint32_t>(renderer->getRenderHeight());
+	FrameServerInputHeader header;
+	memcpy(&header, input, sizeof(header));
+	colorIndex = 1 - colorIndex;
+	colors[colorIndex]->loadFromMemory(input + frameServerHeaderSize, GL_RGBA, GL_UNSIGNED_BYTE);
+	depth->loadFromMemory(input + getInputDepthOffset(w, h), GL_RED, GL_FLOAT);
+	motionVector->loadFromMemory(input + getInputMotionVectorOffset(w, h), GL_RG, GL_FLOAT);
+	if (!renderer->submitFrame(colors[colorIndex]->getID(), depth->getID(), motionVector->getID(), header.jitterX, header.jitterY))
+	{
+		return "Frame not accepted, see the server output";
+	}
+
+	// Read back straight into the slots
+	const size_t slotSize = getOutputSlotSize(static_cast<uint32_t>(renderer->getPresentationWidth()), static_cast<uint32_t>(renderer->getPresentationHeight()));
+	response.firstSlot = nextSlot;
+	while (shared_ptr<Texture> result = renderer->receiveFrame())
+	{
+		unsigned char* slot = output + slotSize * nextSlot;
+		FrameServerSlotHeader slotHeader;
+		slotHeader.frame = outputFrame++;
+		slotHeader.isGenerated = response.outputCount > 0 ? 1 : 0;
+		memcpy(slot, &slotHeader, sizeof(slotHeader));
+		result->getImage(GL_RGBA, GL_UNSIGNED_BYTE, slot + frameServerHeaderSize);
+		nextSlot = (nextSlot + 1) % slotCount;
+		response.outputCount++;
+	}
+	return "";
+}
+
+void FrameServer::closeSegments()
+{
+	if (input)
+	{
+		// Ends the sequence, statistics and dumps of the renderer are written
+		renderer->endFrames();
+		munmap(input, inputSize);
+		input = nullptr;
+	}
+	if (output)
+	{
+		munmap(output, outputSize);
+		output = nullptr;
+	}
+	// The client keeps its mappings until it unmaps them
+	if (!inputSegment.empty())
+	{
+		shm_unlink(inputSegment.c_str());
+		shm_unlink(outputSegment.c_str());
+		inputSegment.clear();
+		outputSegment.clear();
+	}
+}
+#else
+#include <iostream>
+
+FrameServer::FrameServer(const std::string& socketPath, const Options& baseOptions) :
+	socketPath(socketPath), baseOptions(baseOptions), colorIndex(0), segmentCount(0), input(nullptr), output(nullptr),
+	inputSize(0), outputSize(0), slotCount(0), nextSlot(0), outputFrame(0)
+{
+}
+
+FrameServer::~FrameServer()
+{
+}
+
+bool FrameServer::run()
+{
+	std::cout << "ERROR: The frame server needs Unix domain sockets and POSIX shared memory" << std::endl;
+	return false;
+}
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <string>
+
+#include "frame_server_protocol.h"
+#include "offscreen_renderer.h"
+#include "options.h"
+
+// Runs OffscreenRenderer for one client at a time behind a Unix domain socket (POSIX only), frames are exchanged through
+// shared memory as described in frame_server_protocol.h. The OpenGL context and the renderer of the last configuration,
+// with its programs, LUT and textures, stay alive between sequences and connections.
+class FrameServer
+{
+public:
+	// Options of the requests are applied after baseOptions
+	FrameServer(const std::string& socketPath, const Options& baseOptions);
+
+	~FrameServer();
+
+	// Needs a current OpenGL context. Serves until a Shutdown request, false with an ERROR message if the socket
+	// cannot be listened on
+	bool run();
+private:
+	// Each sets response, or returns an error message
+	std::string open(const FrameServerRequest& request, FrameServerResponse& response);
+	std::string submit(FrameServerResponse& response);
+	void closeSegments();
+
+	std::string socketPath;
+	Options baseOptions;
+
+	// Renderer of the options of the last Open
+	Options rendererOptions;
+	shared_ptr<OffscreenRenderer> renderer;
+	// Upload textures of the input planes, the color alternates as submitFrame() requires
+	shared_ptr<Texture> colors[2];
+	shared_ptr<Texture> depth;
+	shared_ptr<Texture> motionVector;
+	int colorIndex;
+
+	// Mapped segments of the current sequence
+	int segmentCount;
+	std::string inputSegment;
+	std::string outputSegment;
+	unsigned char* input;
+	unsigned char* output;
+	size_t inputSize;
+	size_t outputSize;
+	uint32_t slotCount;
+	uint32_t nextSlot;
+	int outputFrame;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Messages of FrameServer over its Unix domain socket and the layout of its shared memory, also read by
+// tools/frame_client.cpp. Every request is answered by one response. Open configures the renderer and creates two POSIX
+// shared memory segments named in the response: the client writes a frame into the input segment and sends Submit, the
+// server writes its outputs into slots of the output ring before responding.
+const char frameServerMagic[4] = { 'M', 'F', 'G', 'S' };
+const uint32_t frameServerVersion = 1;
+
+enum class FrameServerRequestType : uint32_t
+{
+	Open,       // Configures the renderer with options and starts a new sequence, the last segments are removed
+	Submit,     // Runs the frame in the input segment
+	Close,      // Removes the segments
+	Shutdown    // Stops the server after responding
+};
+
+struct FrameServerRequest
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t type;              // FrameServerRequestType
+	char options[2048];         // Open: configuration members of offscreen_renderer.h, one "name=value" per line (blank lines skipped, others fail the Open)
+};
+
+struct FrameServerResponse
+{
+	char magic[4];
+	uint32_t status;            // 0 on success, otherwise message says why
+	// Open: frame sizes and the segments to map (shm_open names)
+	uint32_t renderWidth;
+	uint32_t renderHeight;
+	uint32_t presentationWidth;
+	uint32_t presentationHeight;
+	uint32_t slotCount;
+	char inputSegment[64];
+	char outputSegment[64];
+	// Submit: the outputs are in slots firstSlot, firstSlot + 1, ... (wrapping), in presentation order
+	uint32_t firstSlot;
+	uint32_t outputCount;
+	char message[256];
+};
+
+// Input segment: the header, then the color (RGBA8), depth (float) and motion vector (two floats) planes of render
+// size, rows from y = 0, in the conventions of mobfgsr.h
+struct FrameServerInputHeader
+{
+	float jitterX;
+	float jitterY;
+};
+
+// Output segment: slotCount slots, each the header and presentation size RGBA8 pixels
+struct FrameServerSlotHeader
+{
+	int32_t frame;              // Output frame of the sequence
+	uint32_t isGenerated;
+};
+
+// Headers are padded so the planes stay aligned
+const size_t frameServerHeaderSize = 64;
+
+// The color plane starts at frameServerHeaderSize
+inline size_t getInputDepthOffset(uint32_t width, uint32_t height)
+{
+	return frameServerHeaderSize + static_cast<size_t>(width) * height * 4;
+}
+
+inline size_t getInputMotionVectorOffset(uint32_t width, uint32_t height)
+{
+	return getInputDepthOffset(width, height) + static_cast<size_t>(width) * height * sizeof(float);
+}
+
+inline size_t getInputSegmentSize(uint32_t width, uint32_t height)
+{
+	return getInputMotionVectorOffset(width, height) + static_cast<size_t>(width) * height * 2 * sizeof(float);
+}
+
+inline size_t getOutputSlotSize(uint32_t width, uint32_t height)
+{
+	return frameServerHeaderSize + static_cast<size_t>(width) * height * 4;
+}
@@ -0,0 +1,12 @@
+#include "input_cache.h"
+
+void InputCache::load(Texture& texture, const std::string& path, GLenum sourceFormat, GLenum sourceType)
+{
+	std::shared_ptr<Texture>& cached = textures[path];
+	if (!cached || cached->getFormat() != texture.getFormat() || cached->getWidth() != texture.getWidth() || cached->getHeight() != texture.getHeight())
+	{
+		cached = std::make_shared<Texture>(texture.getFormat(), texture.getWidth(), texture.getHeight(), GL_NEAREST);
+		cached->loadFromFile(path, sourceFormat, sourceType);
+	}
+	texture.copyFrom(*cached, texture.getWidth(), texture.getHeight());
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <glad/glad.h>
+
+#include "texture.h"
+
+// Decoded input images kept on the GPU by path, so the renderers of a parameter sweep decode every file only once
+class InputCache
+{
+public:
+	// Copies the image of path into texture, decoding it into a texture of the same format on first use
+	void load(Texture& texture, const std::string& path, GLenum sourceFormat, GLenum sourceType);
+
+	int getImageCount() const { return static_cast<int>(textures.size()); }
+private:
+	std::map<std::string, std::shared_ptr<Texture>> textures;
+};
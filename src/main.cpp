@@ -1,16 +1,157 @@
 #include <glad/glad.h>
+#ifdef ENABLE_GLES
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#else
 #include <GLFW/glfw3.h>
+#endif
 #include <iostream>
+#include "frame_server.h"
 #include "offscreen_renderer.h"
+#include "options.h"
+#include "parameter_sweep.h"
 
+#ifdef ENABLE_GLES
+// OpenGL ES 3.1 context on a 1x1 pbuffer, rendering is offscreen. Mesa's surfaceless platform needs no display server.
+static bool createGLESContext()
+{
+	EGLDisplay display = EGL_NO_DISPLAY;
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+	if (clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay)
+	{
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_ES_API))
+	{
+		std::cout << "Failed to initialize EGL" << std::endl;
+		return false;
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_NONE,
+	};
+	const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+	const EGLint contextAttributes[] =
+	{
+		EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+		EGL_CONTEXT_MINOR_VERSION_KHR, 1,
+		EGL_NONE,
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		std::cout << "Failed to find an OpenGL ES 3 EGL config" << std::endl;
+		return false;
+	}
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+	{
+		std::cout << "Failed to create OpenGL ES 3.1 context" << std::endl;
+		return false;
+	}
+
+	// Loads the entry points up to the version parsed from GL_VERSION ("OpenGL ES 3.1" -> 3.1). OpenGL ES 3.1 also has
+	// the image load/store and compute functions of OpenGL 4.2/4.3.
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+	{
+		std::cout << "Failed to initialize GLAD" << std::endl;
+		return false;
+	}
+	glad_glTexStorage2D = reinterpret_cast<PFNGLTEXSTORAGE2DPROC>(eglGetProcAddress("glTexStorage2D"));
+	glad_glBindImageTexture = reinterpret_cast<PFNGLBINDIMAGETEXTUREPROC>(eglGetProcAddress("glBindImageTexture"));
+	glad_glMemoryBarrier = reinterpret_cast<PFNGLMEMORYBARRIERPROC>(eglGetProcAddress("glMemoryBarrier"));
+	glad_glDispatchCompute = reinterpret_cast<PFNGLDISPATCHCOMPUTEPROC>(eglGetProcAddress("glDispatchCompute"));
+	glad_glDispatchComputeIndirect = reinterpret_cast<PFNGLDISPATCHCOMPUTEINDIRECTPROC>(eglGetProcAddress("glDispatchComputeIndirect"));
+	std::cout << "OpenGL ES: " << glGetString(GL_VERSION) << ", " << glGetString(GL_RENDERER) << std::endl;
+	return true;
+}
+#else
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow* window);
 
 int screenWidth = 800;
 int screenHeight = 600;
+#endif
 
-int main()
+int main(int argc, char** argv)
 {	
+	Options options;
+	Arguments arguments;
+	ParameterSweep::Parameters sweepParameters;
+	if (!parseArguments(argc, argv, options, arguments) ||
+		(!arguments.sweepPath.empty() && !ParameterSweep::loadParameters(arguments.sweepPath, sweepParameters)))
+	{
+		return -1;
+	}
+	// The frame server and the sweeps create their own renderers, their options are only checked here
+	const bool isServingOrSweeping = !arguments.socketPath.empty() || !arguments.sweepPath.empty();
+	shared_ptr<OffscreenRenderer> offscreenRenderer;
+	if (isServingOrSweeping)
+	{
+		if (!OffscreenRenderer::validateOptions(options))
+		{
+			return -1;
+		}
+	}
+	else
+	{
+		offscreenRenderer = make_shared<OffscreenRenderer>(options);
+		if (!offscreenRenderer->isConfigured())
+		{
+			return -1;
+		}
+	}
+	// Runs the renderer configured by the options, one renderer per combination of the swept values, or serves frames of
+	// clients with the options as defaults
+	auto run = [&]()
+	{
+		if (!arguments.socketPath.empty())
+		{
+			FrameServer server(arguments.socketPath, options);
+			return server.run();
+		}
+		if (arguments.sweepPath.empty())
+		{
+			// Plain runs stay on execute() whatever the backend: the input directories hold packed RGBA8 depth and
+			// motion vectors, camera matrices and HR color, which execute() decodes with the load passes on the GPU
+			// and times with the frame, while the C API of mobfgsr.h takes already decoded textures. Decoding them
+			// here would duplicate those passes (on the CPU, tools/frame_client.cpp only matches on llvmpipe) and
+			// lose Backend::Validate, so the submitFrame() path behind the C API is exercised through --serve instead
+			offscreenRenderer->execute();
+			return true;
+		}
+		ParameterSweep sweep(options, sweepParameters, arguments.referenceDirectory);
+		return sweep.run();
+	};
+	// The frame server and the sweeps run their renderers on OpenGL whatever the backend option, only a plain run of
+	// Backend::CPU goes without a context
+	const bool requiresOpenGL = isServingOrSweeping || offscreenRenderer->requiresOpenGL();
+	if (!requiresOpenGL)
+	{
+		// CPU backend only, no window or context
+		return run() ? 0 : -1;
+	}
+
+#ifdef ENABLE_GLES
+	if (!createGLESContext())
+	{
+		return -1;
+	}
+	return run() ? 0 : -1;
+#else
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -34,8 +175,11 @@ int main()
         return -1;
     }
 
-	OffscreenRenderer offscreenRenderer;
-	offscreenRenderer.execute();
+	if (!run())
+	{
+		glfwTerminate();
+		return -1;
+	}
 	
     while (!glfwWindowShouldClose(window))
     {
@@ -49,8 +193,10 @@ int main()
     glfwTerminate();
 
 	return 0;
+#endif
 }
 
+#ifndef ENABLE_GLES
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	screenWidth = width;
@@ -64,4 +210,5 @@ void processInput(GLFWwindow* window)
     {
         glfwSetWindowShouldClose(window, true);
     }
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
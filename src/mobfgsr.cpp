@@ -0,0 +1,171 @@
+#include "mobfgsr.h"
+
+#include <glad/glad.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "external_memory.h"
+#include "offscreen_renderer.h"
+
+struct MobFGSRContext
+{
+	shared_ptr<OffscreenRenderer> renderer;
+	// Last received output
+	shared_ptr<Texture> output;
+	MobFGSRGetProcAddress getProcAddress;
+	bool isExternalMemoryLoaded;
+	// Memory of imported textures, deleted after the renderer
+	std::vector<shared_ptr<ExternalMemory>> externalMemories;
+};
+
+static std::string toString(float value)
+{
+	std::stringstream ss;
+	ss << std::setprecision(9) << value;
+	return ss.str();
+}
+
+static bool loadOpenGL(MobFGSRGetProcAddress getProcAddress)
+{
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(getProcAddress)))
+	{
+		return false;
+	}
+#ifdef ENABLE_GLES
+	// Entry points of OpenGL 4.2/4.3 that OpenGL ES 3.1 also has, like createGLESContext() in main.cpp
+	glad_glTexStorage2D = reinterpret_cast<PFNGLTEXSTORAGE2DPROC>(getProcAddress("glTexStorage2D"));
+	glad_glBindImageTexture = reinterpret_cast<PFNGLBINDIMAGETEXTUREPROC>(getProcAddress("glBindImageTexture"));
+	glad_glMemoryBarrier = reinterpret_cast<PFNGLMEMORYBARRIERPROC>(getProcAddress("glMemoryBarrier"));
+	glad_glDispatchCompute = reinterpret_cast<PFNGLDISPATCHCOMPUTEPROC>(getProcAddress("glDispatchCompute"));
+	glad_glDispatchComputeIndirect = reinterpret_cast<PFNGLDISPATCHCOMPUTEINDIRECTPROC>(getProcAddress("glDispatchComputeIndirect"));
+#endif
+	return true;
+}
+
+void mobfgsrGetDefaultContextDesc(MobFGSRContextDesc* desc)
+{
+	desc->renderWidth = 1920;
+	desc->renderHeight = 1080;
+	desc->enableSuperResolution = 0;
+	desc->generatedFramesCount = 1;
+	desc->depthDiffThresholdSR = 0.01f;
+	desc->colorDiffThresholdFG = 0.01f;
+	desc->depthDiffThresholdFG = 0.004f;
+	desc->resourcesDirectory = "";
+	desc->options = nullptr;
+	desc->optionCount = 0;
+	desc->getProcAddress = nullptr;
+}
+
+MobFGSRContext* mobfgsrCreateContext(const MobFGSRContextDesc* desc)
+{
+	if (desc->getProcAddress && !loadOpenGL(desc->getProcAddress))
+	{
+		std::cout << "ERROR: Failed to load the OpenGL functions" << std::endl;
+		return nullptr;
+	}
+
+	Options options;
+	options.push_back(std::make_pair("backend", "OpenGL"));
+	options.push_back(std::make_pair("renderWidth", std::to_string(desc->renderWidth)));
+	options.push_back(std::make_pair("renderHeight", std::to_string(desc->renderHeight)));
+	options.push_back(std::make_pair("enableSuperResolution", desc->enableSuperResolution ? "true" : "false"));
+	options.push_back(std::make_pair("upsampleScale", desc->enableSuperResolution ? "2.0" : "1.0"));
+	options.push_back(std::make_pair("enableInterpolation", desc->generatedFramesCount > 0 ? "true" : "false"));
+	options.push_back(std::make_pair("generatedFramesCount", std::to_string(desc->generatedFramesCount)));
+	options.push_back(std::make_pair("depthDiffThresholdSR", toString(desc->depthDiffThresholdSR)));
+	options.push_back(std::make_pair("colorDiffThresholdFG", toString(desc->colorDiffThresholdFG)));
+	options.push_back(std::make_pair("depthDiffThresholdFG", toString(desc->depthDiffThresholdFG)));
+	if (desc->resourcesDirectory)
+	{
+		options.push_back(std::make_pair("resourcesDirectory", desc->resourcesDirectory));
+	}
+	for (int i = 0; i < desc->optionCount; i++)
+	{
+		std::pair<std::string, std::string> option;
+		if (!parseOption(desc->options[i], option))
+		{
+			std::cout << "ERROR: Expected name=value, not " << desc->options[i] << std::endl;
+			return nullptr;
+		}
+		options.push_back(option);
+	}
+
+	shared_ptr<OffscreenRenderer> renderer = make_shared<OffscreenRenderer>(options, true);
+	if (!renderer->isConfigured() || !renderer->beginFrames())
+	{
+		return nullptr;
+	}
+	MobFGSRContext* context = new MobFGSRContext;
+	context->renderer = renderer;
+	context->getProcAddress = desc->getProcAddress;
+	context->isExternalMemoryLoaded = false;
+	return context;
+}
+
+int mobfgsrSubmitFrame(MobFGSRContext* context, const MobFGSRFrameDesc* frame)
+{
+	context->output = nullptr;
+	return context->renderer->submitFrame(frame->colorTexture, frame->depthTexture, frame->motionVectorTexture,
+		frame->jitterX, frame->jitterY) ? 1 : 0;
+}
+
+int mobfgsrReceiveFrame(MobFGSRContext* context, unsigned int* texture)
+{
+	context->output = context->renderer->receiveFrame();
+	if (!context->output)
+	{
+		return 0;
+	}
+	*texture = context->output->getID();
+	return 1;
+}
+
+int mobfgsrSetOutputTextures(MobFGSRContext* context, const MobFGSROutputDesc* outputs)
+{
+	std::vector<GLuint> historyTextures;
+	if (outputs->historyTextures[0] || outputs->historyTextures[1])
+	{
+		historyTextures.push_back(outputs->historyTextures[0]);
+		historyTextures.push_back(outputs->historyTextures[1]);
+	}
+	std::vector<GLuint> generatedTextures(outputs->generatedTextures, outputs->generatedTextures + outputs->generatedTextureCount);
+	return context->renderer->setOutputTextures(historyTextures, generatedTextures) ? 1 : 0;
+}
+
+unsigned int mobfgsrImportTexture(MobFGSRContext* context, const MobFGSRMemoryImportDesc* desc)
+{
+	if (!context->isExternalMemoryLoaded)
+	{
+		if (!context->getProcAddress || !ExternalMemory::loadFunctions(context->getProcAddress))
+		{
+			std::cout << "ERROR: Importing memory needs GL_EXT_memory_object_fd and getProcAddress" << std::endl;
+			return 0;
+		}
+		context->isExternalMemoryLoaded = true;
+	}
+	shared_ptr<ExternalMemory> memory = make_shared<ExternalMemory>(desc->fd, desc->size, desc->dedicated != 0);
+	if (!memory->isValid())
+	{
+		return 0;
+	}
+	const GLuint texture = memory->createTexture(desc->format, desc->width, desc->height, desc->offset, desc->linearTiling != 0);
+	if (texture)
+	{
+		context->externalMemories.push_back(memory);
+	}
+	return texture;
+}
+
+void mobfgsrDestroyContext(MobFGSRContext* context)
+{
+	if (!context)
+	{
+		return;
+	}
+	context->renderer->endFrames();
+	context->output = nullptr;
+	context->renderer = nullptr;
+	delete context;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// C API of the MobFGSR library: super resolution and frame generation of frames rendered by the application, in its
+// OpenGL 4.3 context (OpenGL ES 3.1 with ENABLE_GLES). Call every function with that context current. Frames are
+// exchanged as texture names, nothing is copied to the CPU or read from and written to disk.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MobFGSRContext MobFGSRContext;
+
+typedef void* (*MobFGSRGetProcAddress)(const char* name);
+
+typedef struct MobFGSRContextDesc
+{
+	// Size of the submitted frames, the outputs are twice as large with super resolution
+	int renderWidth;
+	int renderHeight;
+	int enableSuperResolution;
+	// Frames generated between two submitted frames, 0 disables interpolation
+	int generatedFramesCount;
+	float depthDiffThresholdSR;
+	float colorDiffThresholdFG;
+	float depthDiffThresholdFG;
+	// Directory of the shaders and the LUT (MobFGSR/resources/)
+	const char* resourcesDirectory;
+	// Further configuration members of offscreen_renderer.h as "name=value", applied last
+	const char* const* options;
+	int optionCount;
+	// Loads the OpenGL functions (e.g. glfwGetProcAddress or eglGetProcAddress), NULL if glad is already loaded
+	MobFGSRGetProcAddress getProcAddress;
+} MobFGSRContextDesc;
+
+typedef struct MobFGSRFrameDesc
+{
+	// Render size, read in place until the next mobfgsrSubmitFrame(). GL_RGBA8 color, depth in red and motion vectors
+	// in red/green as resources/IO/LoadDepth.comp and LoadMotionVector.comp write them. Interpolation without super
+	// resolution keeps the color as history until the frame after, so colors alternate between two textures
+	unsigned int colorTexture;
+	unsigned int depthTexture;
+	unsigned int motionVectorTexture;
+	// With super resolution, the color of LR pixel p was rendered at p + 0.5 - jitter (in LR pixels)
+	float jitterX;
+	float jitterY;
+} MobFGSRFrameDesc;
+
+typedef struct MobFGSROutputDesc
+{
+	// Caller textures written instead of the internal ones, GL_RGBA8 of presentation size. With super resolution the
+	// upsampled frames alternate between both historyTextures (0 keeps the internal ones), which are then the rendered
+	// outputs, each read as history by the next submitted frame
+	unsigned int historyTextures[2];
+	// Generated frames are written to these in turn
+	const unsigned int* generatedTextures;
+	int generatedTextureCount;
+} MobFGSROutputDesc;
+
+typedef struct MobFGSRMemoryImportDesc
+{
+	// Opaque file descriptor of the memory (e.g. from vkGetMemoryFdKHR), owned by OpenGL after a successful import
+	int fd;
+	// Size of the allocation and offset of the image in it
+	unsigned long long size;
+	unsigned long long offset;
+	// Allocated with VkMemoryDedicatedAllocateInfo
+	int dedicated;
+	// Image created with VK_IMAGE_TILING_LINEAR instead of VK_IMAGE_TILING_OPTIMAL
+	int linearTiling;
+	// Internal format matching the image format (GL_RGBA8 for VK_FORMAT_R8G8B8A8_UNORM, GL_R32F, GL_RG16F)
+	unsigned int format;
+	int width;
+	int height;
+} MobFGSRMemoryImportDesc;
+
+// Defaults of offscreen_renderer.h, without super resolution and with one generated frame
+void mobfgsrGetDefaultContextDesc(MobFGSRContextDesc* desc);
+
+// NULL with an ERROR message on stdout if the configuration is invalid
+MobFGSRContext* mobfgsrCreateContext(const MobFGSRContextDesc* desc);
+
+// Runs the rendered frame, 0 with an ERROR message if a texture does not match the description
+int mobfgsrSubmitFrame(MobFGSRContext* context, const MobFGSRFrameDesc* frame);
+
+// Writes the next output of the last submitted frame to texture and returns 1, or returns 0 after the last. The
+// outputs come in presentation order: the rendered frame (with interpolation the previous one, so the first submitted
+// frame has none), then the generated frames, each generated when it is received. Without output textures, the texture
+// is owned by the context and overwritten by the next call of mobfgsrReceiveFrame() or mobfgsrSubmitFrame(). The
+// rendered frame of interpolation without super resolution is the previously submitted color texture
+int mobfgsrReceiveFrame(MobFGSRContext* context, unsigned int* texture);
+
+// Before the first mobfgsrSubmitFrame(), 0 with an ERROR message if a texture does not match
+int mobfgsrSetOutputTextures(MobFGSRContext* context, const MobFGSROutputDesc* outputs);
+
+// Texture in memory exported by another API in the same process (GL_EXT_memory_object_fd, needs getProcAddress), to be
+// submitted or set as output. The exporting API finishes its writes before the texture is submitted and waits for
+// OpenGL before reusing it (fences, or semaphores through GL_EXT_semaphore_fd). The texture belongs to the context, 0
+// with an ERROR message if the import failed
+unsigned int mobfgsrImportTexture(MobFGSRContext* context, const MobFGSRMemoryImportDesc* desc);
+
+void mobfgsrDestroyContext(MobFGSRContext* context);
+
+#ifdef __cplusplus
+}
+#endif
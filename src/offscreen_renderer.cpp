@@ -1,12 +1,411 @@
 ﻿#include "offscreen_renderer.h"
 
 #include "texture.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <set>
 #include <sstream>
 #include <iomanip>
 #include <utility>
+#include <vector>
 
-OffscreenRenderer::OffscreenRenderer()
+// GL_KHR_shader_subgroup, not part of the generated loader
+#ifndef GL_SUBGROUP_SUPPORTED_STAGES_KHR
+#define GL_SUBGROUP_SUPPORTED_STAGES_KHR    0x9535
+#define GL_SUBGROUP_SUPPORTED_FEATURES_KHR  0x9536
+#define GL_SUBGROUP_FEATURE_SHUFFLE_BIT_KHR 0x00000010
+#endif
+
+static bool hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        if (strcmp(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)), name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Frame stats counters, in the order of the FRAME_STAT_* indices of the kernels
+static const char* const frameStatNames[] =
+{
+    "reprojected", "out_of_screen",                                             // Reproject_I
+    "hole_filled", "hole_unfilled",                                             // Fill
+    "warp_t1_only", "warp_t0_only", "warp_luma_similar", "warp_blended", "warp_occlusion",   // Warp_I
+    "history_accepted", "history_rejected"                                      // BlendHistory
+};
+static const int frameStatCount = sizeof(frameStatNames) / sizeof(frameStatNames[0]);
+static const int frameStatsLatency = 3;
+static const int hashLatency = 3;
+static const int hashBufferSize = 2 + 4;      // Hash words, then the projections of HashMode::Tolerance
+
+// Channels and component type of a dumped texture, read back as RGBA and stripped to its own channels
+static bool getDumpFormat(GLenum internalFormat, uint32_t& channels, DumpComponentType& componentType)
+{
+    switch (internalFormat)
+    {
+    case GL_R32UI:      channels = 1; componentType = DumpComponentType::UInt32; return true;
+    case GL_RG32UI:     channels = 2; componentType = DumpComponentType::UInt32; return true;
+    case GL_RGBA32UI:   channels = 4; componentType = DumpComponentType::UInt32; return true;
+    case GL_R16F:
+    case GL_R32F:       channels = 1; componentType = DumpComponentType::Float32; return true;
+    case GL_RG16F:      channels = 2; componentType = DumpComponentType::Float32; return true;
+    case GL_RGBA16F:    channels = 4; componentType = DumpComponentType::Float32; return true;
+    case GL_RGBA8:      channels = 4; componentType = DumpComponentType::UInt8; return true;
+    default:            return false;
+    }
+}
+
+// Normal halves only, for the motion scaling of the dispatch order benchmark (denormals flush to zero, larger values
+// saturate, the mantissa is truncated)
+static float halfToFloat(uint16_t half)
+{
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t bits = static_cast<uint32_t>(half & 0x8000u) << 16;
+    if (exponent != 0)
+    {
+        bits |= ((exponent + 112) << 23) | (static_cast<uint32_t>(half & 0x3FFu) << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const int exponent = static_cast<int>((bits >> 23) & 0xFFu) - 112;
+    if (exponent <= 0)
+    {
+        return sign;
+    }
+    if (exponent >= 31)
+    {
+        return static_cast<uint16_t>(sign | 0x7BFFu);
+    }
+    return static_cast<uint16_t>(sign | (exponent << 10) | ((bits >> 13) & 0x3FFu));
+}
+
+static bool hasSubgroupShuffle()
+{
+    if (!hasExtension("GL_KHR_shader_subgroup"))
+    {
+        return false;
+    }
+    GLint stages = 0;
+    GLint features = 0;
+    glGetIntegerv(GL_SUBGROUP_SUPPORTED_STAGES_KHR, &stages);
+    glGetIntegerv(GL_SUBGROUP_SUPPORTED_FEATURES_KHR, &features);
+    return (stages & GL_COMPUTE_SHADER_BIT) != 0 && (features & GL_SUBGROUP_FEATURE_SHUFFLE_BIT_KHR) != 0;
+}
+
+static mat4 getIdentity()
+{
+    mat4 result = {};
+    result.m[0] = result.m[5] = result.m[10] = result.m[15] = 1.0f;
+    return result;
+}
+
+static mat4 multiply(const mat4& a, const mat4& b)
+{
+    mat4 result = {};
+    for (int column = 0; column < 4; column++)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                result.m[column * 4 + row] += a.m[i * 4 + row] * b.m[column * 4 + i];
+            }
+        }
+    }
+    return result;
+}
+
+// Gauss-Jordan elimination with partial pivoting in double precision, false if m is singular
+static bool invert(const mat4& m, mat4& result)
+{
+    double a[4][8];
+    for (int row = 0; row < 4; row++)
+    {
+        for (int column = 0; column < 4; column++)
+        {
+            a[row][column] = m.m[column * 4 + row];
+            a[row][column + 4] = row == column ? 1.0 : 0.0;
+        }
+    }
+    for (int column = 0; column < 4; column++)
+    {
+        int pivot = column;
+        for (int row = column + 1; row < 4; row++)
+        {
+            if (std::abs(a[row][column]) > std::abs(a[pivot][column]))
+            {
+                pivot = row;
+            }
+        }
+        if (a[pivot][column] == 0.0)
+        {
+            return false;
+        }
+        std::swap(a[column], a[pivot]);
+        const double scale = 1.0 / a[column][column];
+        for (int i = 0; i < 8; i++)
+        {
+            a[column][i] *= scale;
+        }
+        for (int row = 0; row < 4; row++)
+        {
+            const double factor = a[row][column];
+            if (row != column && factor != 0.0)
+            {
+                for (int i = 0; i < 8; i++)
+                {
+                    a[row][i] -= factor * a[column][i];
+                }
+            }
+        }
+    }
+    for (int row = 0; row < 4; row++)
+    {
+        for (int column = 0; column < 4; column++)
+        {
+            result.m[column * 4 + row] = static_cast<float>(a[row][column + 4]);
+        }
+    }
+    return true;
+}
+
+// Sets an enum from the name of its value, names in declaration order
+template <typename T, size_t N>
+static bool parseEnum(const std::string& value, const char* const (&names)[N], T& result)
+{
+    // Accepts "FillMode::PushPull" as well as "PushPull"
+    const std::string name = value.substr(value.rfind(':') == std::string::npos ? 0 : value.rfind(':') + 1);
+    for (size_t i = 0; i < N; i++)
+    {
+        if (name == names[i])
+        {
+            result = static_cast<T>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OffscreenRenderer::setOption(const std::string& name, const std::string& value)
+{
+    const std::pair<const char*, bool*> boolOptions[] =
+    {
+        { "enableSuperResolution", &enableSuperResolution },
+        { "enableInterpolation", &enableInterpolation },
+        { "enableNativeLRColor", &enableNativeLRColor },
+        { "enableCameraMotionVectors", &enableCameraMotionVectors },
+        { "enableSparseMotionVectors", &enableSparseMotionVectors },
+        { "enableTileClassification", &enableTileClassification },
+        { "enableSubgroupShuffle", &enableSubgroupShuffle },
+        { "enableLocalReprojection", &enableLocalReprojection },
+        { "enableGeometryBuffer", &enableGeometryBuffer },
+        { "enableReprojectionStats", &enableReprojectionStats },
+        { "enableDispatchOrderBenchmark", &enableDispatchOrderBenchmark },
+        { "enablePrecisionReport", &enablePrecisionReport },
+        { "enableFrameStats", &enableFrameStats },
+        { "enablePacingSimulation", &enablePacingSimulation },
+    };
+    const std::pair<const char*, int*> intOptions[] =
+    {
+        { "cpuThreadCount", &cpuThreadCount },
+        { "validationTolerance", &validationTolerance },
+        { "generatedFramesCount", &generatedFramesCount },
+        { "renderWidth", &renderWidth },
+        { "renderHeight", &renderHeight },
+        { "startInputFrame", &startInputFrame },
+        { "endInputFrame", &endInputFrame },
+        { "dumpStartFrame", &dumpStartFrame },
+        { "dumpEndFrame", &dumpEndFrame },
+    };
+    const std::pair<const char*, float*> floatOptions[] =
+    {
+        { "upsampleScale", &upsampleScale },
+        { "depthDiffThresholdSR", &depthDiffThresholdSR },
+        { "colorDiffThresholdFG", &colorDiffThresholdFG },
+        { "depthDiffThresholdFG", &depthDiffThresholdFG },
+        { "depthScale", &depthScale },
+        { "depthBias", &depthBias },
+        { "renderFrameTime", &renderFrameTime },
+        { "hashTolerance", &hashTolerance },
+    };
+    const std::pair<const char*, std::string*> stringOptions[] =
+    {
+        { "inputLrColorDirectory", &inputLrColorDirectory },
+        { "inputLrJitterPath", &inputLrJitterPath },
+        { "inputLrDepthDirectory", &inputLrDepthDirectory },
+        { "inputLrMotionVectorXDirectory", &inputLrMotionVectorXDirectory },
+        { "inputLrMotionVectorYDirectory", &inputLrMotionVectorYDirectory },
+        { "inputHrColorDirectory", &inputHrColorDirectory },
+        { "inputHrDepthDirectory", &inputHrDepthDirectory },
+        { "inputHrMotionVectorXDirectory", &inputHrMotionVectorXDirectory },
+        { "inputHrMotionVectorYDirectory", &inputHrMotionVectorYDirectory },
+        { "inputCameraMatrixPath", &inputCameraMatrixPath },
+        { "outputDirectory", &outputDirectory },
+        { "resourcesDirectory", &resourcesDirectory },
+        { "dumpResources", &dumpResources },
+        { "renderFrameTimeTracePath", &renderFrameTimeTracePath },
+        { "hashResources", &hashResources },
+        { "goldenHashPath", &goldenHashPath },
+    };
+    static const char* const backendNames[] = { "OpenGL", "CPU", "Validate" };
+    static const char* const fillModeNames[] = { "Full", "HoleList", "PushPull" };
+    static const char* const reprojectionEngineNames[] = { "Scatter", "Gather", "RasterPoints", "RasterMesh" };
+    static const char* const dispatchOrderNames[] = { "RowMajor", "Morton", "Column" };
+    static const char* const colorPrecisionNames[] = { "FP32", "FP16Emulated" };
+    static const char* const hashModeNames[] = { "Off", "Bitwise", "Tolerance" };
+    static const char* const reprojectionFormatNames[] = { "Auto", "Packed32", "Wide64" };
+
+    std::istringstream ss(value);
+    for (const auto& option : boolOptions)
+    {
+        if (name == option.first)
+        {
+            if (value != "true" && value != "false" && value != "1" && value != "0")
+            {
+                std::cout << "ERROR: " << name << " must be true or false, not " << value << std::endl;
+                return false;
+            }
+            *option.second = value == "true" || value == "1";
+            return true;
+        }
+    }
+    for (const auto& option : intOptions)
+    {
+        if (name == option.first)
+        {
+            if (!(ss >> *option.second) || !ss.eof())
+            {
+                std::cout << "ERROR: " << name << " must be an integer, not " << value << std::endl;
+                return false;
+            }
+            return true;
+        }
+    }
+    for (const auto& option : floatOptions)
+    {
+        if (name == option.first)
+        {
+            // Accepts a trailing f as in the member initializers
+            std::string number = value;
+            if (!number.empty() && (number.back() == 'f' || number.back() == 'F'))
+            {
+                number.pop_back();
+            }
+            std::istringstream numberStream(number);
+            if (!(numberStream >> *option.second) || !numberStream.eof())
+            {
+                std::cout << "ERROR: " << name << " must be a number, not " << value << std::endl;
+                return false;
+            }
+            return true;
+        }
+    }
+    for (const auto& option : stringOptions)
+    {
+        if (name == option.first)
+        {
+            *option.second = value;
+            return true;
+        }
+    }
+    bool isEnum = true;
+    bool isValid = false;
+    if (name == "backend")
+    {
+        isValid = parseEnum(value, backendNames, backend);
+    }
+    else if (name == "fillMode")
+    {
+        isValid = parseEnum(value, fillModeNames, fillMode);
+    }
+    else if (name == "reprojectionFormat")
+    {
+        isValid = parseEnum(value, reprojectionFormatNames, reprojectionFormat);
+    }
+    else if (name == "reprojectionEngine")
+    {
+        isValid = parseEnum(value, reprojectionEngineNames, reprojectionEngine);
+    }
+    else if (name == "gatherDispatchOrder")
+    {
+        isValid = parseEnum(value, dispatchOrderNames, gatherDispatchOrder);
+    }
+    else if (name == "colorPrecision")
+    {
+        isValid = parseEnum(value, colorPrecisionNames, colorPrecision);
+    }
+    else if (name == "hashMode")
+    {
+        isValid = parseEnum(value, hashModeNames, hashMode);
+    }
+    else
+    {
+        isEnum = false;
+    }
+    if (!isEnum)
+    {
+        std::cout << "ERROR: Unknown option " << name << std::endl;
+    }
+    else if (!isValid)
+    {
+        std::cout << "ERROR: Unknown value " << value << " of " << name << std::endl;
+    }
+    return isValid;
+}
+
+OffscreenRenderer::OffscreenRenderer(const Options& options, bool externalInputs)
 {
+    configured = true;
+    std::set<std::string> givenOptions;
+    for (const auto& option : options)
+    {
+        configured = setOption(option.first, option.second) && configured;
+        givenOptions.insert(option.first);
+    }
+    // The combinations below fall back to a supported configuration, only options given explicitly are reported
+    auto warnOverride = [&givenOptions](const std::string& name, const std::string& reason)
+    {
+        if (givenOptions.count(name))
+        {
+            std::cout << "WARNING: " << name << " ignored: " << reason << std::endl;
+        }
+    };
+    hasExternalInputs = externalInputs;
+    hasBegunFrames = false;
+    submittedFrameCount = 0;
+    receiveCycleFrameIndex = 0;
+    cycleOutputFrame = 0;
+    generatedOutputIndex = 0;
+    if (hasExternalInputs)
+    {
+        // Submitted color is already LR with its jitter offset, depth and motion vectors are decoded
+        if (backend != Backend::OpenGL || enableCameraMotionVectors)
+        {
+            std::cout << "ERROR: Submitted frames need Backend::OpenGL and motion vector inputs" << std::endl;
+            configured = false;
+        }
+        enableNativeLRColor = false;
+        enableCameraMotionVectors = false;
+    }
     if (!enableInterpolation)
     {
         generatedFramesCount = 0;
@@ -14,7 +413,27 @@ OffscreenRenderer::OffscreenRenderer()
     if (!enableSuperResolution)
     {
         upsampleScale = 1.0f;
+        enableNativeLRColor = false;
+    }
+    if (enableNativeLRColor)
+    {
+        loadJitterOffsets();
+    }
+    if (!enableCameraMotionVectors)
+    {
+        enableSparseMotionVectors = false;
+    }
+    if (enableCameraMotionVectors)
+    {
+        loadViewProjections();
     }
+    cameraBlock.reprojection = getIdentity();
+    uniformBuffer = 0;
+    cameraBuffer = 0;
+    reprojectionFramebuffer = 0;
+    reprojectionDepthBuffer = 0;
+    reprojectionVertexArray = 0;
+    reprojectionIndexBuffer = 0;
     
     presentationWidth = static_cast<int>(static_cast<float>(renderWidth) * upsampleScale);
     presentationHeight = static_cast<int>(static_cast<float>(renderHeight) * upsampleScale);
@@ -26,342 +445,2442 @@ OffscreenRenderer::OffscreenRenderer()
     groupX_HR = (presentationWidth + localSize - 1) / localSize;
     groupY_HR = (presentationHeight + localSize - 1) / localSize;
     groupZ_HR = 1;
+    tileCountX = groupX_LR;
+    tileCountY = groupY_LR;
+    groupX_HR_Gather = groupX_HR;
+    groupY_HR_Gather = groupY_HR;
+    if (gatherDispatchOrder == DispatchOrder::Morton)
+    {
+        // Whole 8x8 blocks of workgroups, the padding returns early
+        groupX_HR_Gather = (groupX_HR + 7) / 8 * 8;
+        groupY_HR_Gather = (groupY_HR + 7) / 8 * 8;
+    }
     
-    // Compute shaders
-    loadDepthCS                 = make_shared<ComputeShader>(resourcesDirectory + "IO/LoadDepth.comp");
-    loadMotionVectorCS          = make_shared<ComputeShader>(resourcesDirectory + "IO/LoadMotionVector.comp");
-    loadLRColorCS               = make_shared<ComputeShader>(resourcesDirectory + "IO/LoadLRColor.comp");
-    dilateCS                    = make_shared<ComputeShader>(resourcesDirectory + "Preprocessing/Dilate.comp");
-    clearCS                     = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Clear.comp");
-    reprojectCS_I               = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Reproject_I.comp");
-    fillCS                      = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Fill.comp");
-    warpCS_I                    = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Warp_I.comp");
-    upsampleFirstFrameCS        = make_shared<ComputeShader>(resourcesDirectory + "SuperResolution/UpsampleFirstFrame.comp");
-    blendHistoryCS              = make_shared<ComputeShader>(resourcesDirectory + "SuperResolution/BlendHistory.comp");
+    if (enableTileClassification && (!enableInterpolation || static_cast<float>(static_cast<int>(upsampleScale)) != upsampleScale))
+    {
+        // Tiles map to whole HR workgroups only for integer scales
+        warnOverride("enableTileClassification", "tiles need enableInterpolation and an integer upsampleScale");
+        enableTileClassification = false;
+    }
+    if (reprojectionFormat == ReprojectionFormat::Auto)
+    {
+        // Packed relative positions cover half the screen up to 2048x1024 and saturate on fast motion at higher
+        // resolutions, where 11-bit depth also gets too coarse. 1080p/1440p keep the packed format.
+        reprojectionFormat = renderWidth > 2560 || renderHeight > 1440 ? ReprojectionFormat::Wide64 : ReprojectionFormat::Packed32;
+    }
+    if (reprojectionFormat == ReprojectionFormat::Wide64)
+    {
+        // Tile classification and hole list store packed entries
+        if (enableTileClassification)
+        {
+            warnOverride("enableTileClassification", "tiles need the Packed32 reprojection format");
+            enableTileClassification = false;
+        }
+        if (fillMode == FillMode::HoleList)
+        {
+            warnOverride("fillMode", "HoleList needs the Packed32 reprojection format, using Full");
+            fillMode = FillMode::Full;
+        }
+    }
+#ifdef ENABLE_GLES
+    if (reprojectionFormat == ReprojectionFormat::Wide64 && fillMode == FillMode::PushPull)
+    {
+        // PullFill reads and writes the wide entries in place, OpenGL ES 3.1 only allows that for 32-bit single-channel images
+        warnOverride("fillMode", "OpenGL ES has no PushPull fill of Wide64 entries, using Full");
+        fillMode = FillMode::Full;
+    }
+#endif
+    if (reprojectionEngine == ReprojectionEngine::RasterPoints || reprojectionEngine == ReprojectionEngine::RasterMesh)
+    {
+        if (backend != Backend::OpenGL || reprojectionFormat == ReprojectionFormat::Wide64)
+        {
+            // Rasterization writes packed entries through a framebuffer, the other backends have no raster pipeline
+            warnOverride("reprojectionEngine", "rasterization needs Backend::OpenGL and the Packed32 reprojection format, using Scatter");
+            reprojectionEngine = ReprojectionEngine::Scatter;
+        }
+    }
+    if (backend != Backend::OpenGL && enableGeometryBuffer)
+    {
+        // The CPU backend keeps separate dilated depths and motion vectors
+        warnOverride("enableGeometryBuffer", "the CPU backend keeps separate dilated depths and motion vectors");
+        enableGeometryBuffer = false;
+    }
+    if (reprojectionEngine != ReprojectionEngine::Scatter && fillMode == FillMode::HoleList)
+    {
+        // Holes are listed while scattering, the gather engine fills along its search
+        warnOverride("fillMode", "HoleList needs the Scatter reprojection engine, using Full");
+        fillMode = FillMode::Full;
+    }
+    if (enableTileClassification && fillMode != FillMode::Full)
+    {
+        // Tile classification already restricts Fill to dynamic tiles, static tiles never reach filledReprojection
+        warnOverride("fillMode", "tile classification only fills dynamic tiles, using Full");
+        fillMode = FillMode::Full;
+    }
+#ifdef ENABLE_GLES
+    if (colorPrecision == ColorPrecision::FP16Emulated)
+    {
+        // mediump already applies, see initializeOpenGL()
+        warnOverride("colorPrecision", "OpenGL ES applies mediump to the color math instead of FP16 emulation");
+    }
+#endif
 
-    
-    // Textures
-    if (enableSuperResolution)
+    outputColor = nullptr;
+    cpuOutputColor = nullptr;
+}
+
+bool OffscreenRenderer::validateOptions(const Options& options)
+{
+    return OffscreenRenderer(options).isConfigured();
+}
+
+OffscreenRenderer::~OffscreenRenderer()
+{
+    // Names are only nonzero once initializeOpenGL() ran in the current context
+    if (uniformBuffer)
     {
-        rawInputHRColor         = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_NEAREST);
+        glDeleteBuffers(1, &uniformBuffer);
     }
-    else
+    if (cameraBuffer)
     {
-        rawInputHRColor         = nullptr;
+        glDeleteBuffers(1, &cameraBuffer);
+    }
+    if (reprojectionFramebuffer)
+    {
+        glDeleteFramebuffers(1, &reprojectionFramebuffer);
+        glDeleteRenderbuffers(1, &reprojectionDepthBuffer);
+        glDeleteVertexArrays(1, &reprojectionVertexArray);
+    }
+    if (reprojectionIndexBuffer)
+    {
+        glDeleteBuffers(1, &reprojectionIndexBuffer);
     }
-    rawInputDepth               = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_NEAREST);
-    rawInputMotionVectorX       = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_NEAREST);
-    rawInputMotionVectorY       = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_NEAREST);
+}
 
-    inputColor                  = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_LINEAR);
-    inputDepth                  = make_shared<Texture>(GL_R32F, renderWidth, renderHeight, GL_NEAREST);
-    inputMotionVector           = make_shared<Texture>(GL_RG16F, renderWidth, renderHeight, GL_NEAREST);
+void OffscreenRenderer::setSweepTarget(shared_ptr<InputCache> cache, std::function<void(int, const Texture&)> callback)
+{
+    inputCache = cache;
+    outputCallback = callback;
+}
 
-    sampleLut                   = make_shared<Texture>(GL_R16F, 128, 128, GL_LINEAR);
+void OffscreenRenderer::initializeCPU()
+{
+    // Tile classification and the hole list only skip work, the CPU backend fills every pixel instead. Extrapolation
+    // only runs to validate the passes timed for the pacing simulation.
+    cpuBackend = make_shared<CpuBackend>(renderWidth, renderHeight, presentationWidth, presentationHeight,
+        enableSuperResolution, enableInterpolation, fillMode == FillMode::PushPull,
+        reprojectionFormat == ReprojectionFormat::Wide64, enableNativeLRColor, enableCameraMotionVectors, enableSparseMotionVectors,
+        reprojectionEngine == ReprojectionEngine::Gather, backend == Backend::Validate && enablePacingSimulation && enableInterpolation,
+        cpuThreadCount);
+    cpuBackend->loadLUT(resourcesDirectory + "lut.exr");
+    std::cout << "CPU backend: " << cpuBackend->getThreadCount() << " threads" << std::endl;
+}
 
-    currentDilatedDepth         = make_shared<Texture>(GL_R32F, renderWidth, renderHeight, GL_NEAREST);
-    currentDilatedMotionVector  = make_shared<Texture>(GL_RG16F, renderWidth, renderHeight, GL_NEAREST);
+void OffscreenRenderer::initializeOpenGL()
+{
+    std::vector<std::string> geometryDefines;
+    if (enableGeometryBuffer)
+    {
+        geometryDefines.push_back("ENABLE_GEOMETRY_BUFFER");
+    }
+    std::vector<std::string> frameGenerationDefines = geometryDefines;
+    if (enableTileClassification)
+    {
+        frameGenerationDefines.push_back("ENABLE_TILE_CLASSIFICATION");
+    }
+    if (fillMode == FillMode::HoleList)
+    {
+        frameGenerationDefines.push_back("ENABLE_HOLE_LIST");
+    }
+    std::vector<std::string> reprojectDefines;
+    bool useAtomicInt64 = false;
+    if (reprojectionFormat == ReprojectionFormat::Wide64)
+    {
+        frameGenerationDefines.push_back("ENABLE_WIDE_REPROJECTION");
+        // Local reprojection aggregates 32-bit atomics, so it takes the two-pass path
+        useAtomicInt64 = !enableLocalReprojection && hasExtension("GL_NV_shader_atomic_int64") && hasExtension("GL_ARB_gpu_shader_int64");
+        if (useAtomicInt64)
+        {
+            reprojectDefines.push_back("ENABLE_ATOMIC_INT64");
+        }
+    }
+    if (enableLocalReprojection)
+    {
+        reprojectDefines.push_back("ENABLE_LOCAL_REPROJECTION");
+    }
+    if (enableReprojectionStats)
+    {
+        reprojectDefines.push_back("ENABLE_REPROJECTION_STATS");
+    }
+    reprojectDefines.insert(reprojectDefines.begin(), frameGenerationDefines.begin(), frameGenerationDefines.end());
+    // 3x3 neighborhoods shared through subgroup shuffles, Fill only while it runs on 8x8 pixel blocks
+    std::vector<std::string> neighborhoodDefines;
+    if (enableSubgroupShuffle && hasSubgroupShuffle())
+    {
+        neighborhoodDefines.push_back("ENABLE_SUBGROUP_SHUFFLE");
+    }
+    std::vector<std::string> dilateDefines = neighborhoodDefines;
+    dilateDefines.insert(dilateDefines.end(), geometryDefines.begin(), geometryDefines.end());
+    std::vector<std::string> fillDefines = frameGenerationDefines;
+    std::vector<std::string> warpDefines = frameGenerationDefines;
+    std::vector<std::string> blendHistoryDefines = dilateDefines;
+    if (gatherDispatchOrder != DispatchOrder::RowMajor)
+    {
+        const std::string dispatchOrderDefine = gatherDispatchOrder == DispatchOrder::Morton ? "ENABLE_MORTON_DISPATCH" : "ENABLE_COLUMN_DISPATCH";
+        warpDefines.push_back(dispatchOrderDefine);
+        blendHistoryDefines.push_back(dispatchOrderDefine);
+    }
+    // OpenGL ES already applies mediump
+    std::string precisionDefine;
+#ifndef ENABLE_GLES
+    if (colorPrecision == ColorPrecision::FP16Emulated)
+    {
+        precisionDefine = "ENABLE_FP16_EMULATION";
+    }
+#endif
+    std::vector<std::string> upsampleFirstFrameDefines;
+    std::vector<std::string> copyDefines;
+    const std::vector<std::string> warpReferenceDefines = warpDefines;
+    const std::vector<std::string> blendHistoryReferenceDefines = blendHistoryDefines;
+    if (!precisionDefine.empty())
+    {
+        warpDefines.push_back(precisionDefine);
+        blendHistoryDefines.push_back(precisionDefine);
+        upsampleFirstFrameDefines.push_back(precisionDefine);
+        copyDefines.push_back(precisionDefine);
+    }
+    if (fillMode != FillMode::HoleList)
+    {
+        fillDefines.insert(fillDefines.end(), neighborhoodDefines.begin(), neighborhoodDefines.end());
+    }
+    // Not counted by the FP32 reference kernels
+    if (enableFrameStats)
+    {
+        reprojectDefines.push_back("ENABLE_FRAME_STATS");
+        fillDefines.push_back("ENABLE_FRAME_STATS");
+        warpDefines.push_back("ENABLE_FRAME_STATS");
+        blendHistoryDefines.push_back("ENABLE_FRAME_STATS");
+    }
     
-    if (enableInterpolation)
+    // Compute shaders
+    loadDepthCS                 = make_shared<ComputeShader>(resourcesDirectory + "IO/LoadDepth.comp");
+    if (enableCameraMotionVectors)
     {
-        currentHRColor              = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
-        previousDilatedDepth        = make_shared<Texture>(GL_R32F, renderWidth, renderHeight, GL_NEAREST);
-        previousDilatedMotionVector = make_shared<Texture>(GL_RG16F, renderWidth, renderHeight, GL_NEAREST);
-        previousHRColor             = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+        std::vector<std::string> reconstructDefines;
+        if (enableSparseMotionVectors)
+        {
+            reconstructDefines.push_back("ENABLE_SPARSE_MOTION_VECTORS");
+        }
+        reconstructMotionVectorCS = make_shared<ComputeShader>(resourcesDirectory + "IO/ReconstructMotionVector.comp", reconstructDefines);
     }
-    else if (enableSuperResolution)
+    else
+    {
+        loadMotionVectorCS      = make_shared<ComputeShader>(resourcesDirectory + "IO/LoadMotionVector.comp");
+    }
+    dilateCS                    = make_shared<ComputeShader>(resourcesDirectory + "Preprocessing/Dilate.comp", dilateDefines);
+    clearCS                     = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Clear.comp", frameGenerationDefines);
+    reprojectCS_I               = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Reproject_I.comp", reprojectDefines);
+    fillCS                      = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Fill.comp", fillDefines);
+    resolveMotionCS_I           = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/ResolveMotion_I.comp", frameGenerationDefines);
+    warpCS_I                    = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Warp_I.comp", warpDefines);
+    upsampleFirstFrameCS        = make_shared<ComputeShader>(resourcesDirectory + "SuperResolution/UpsampleFirstFrame.comp", upsampleFirstFrameDefines);
+    blendHistoryCS              = make_shared<ComputeShader>(resourcesDirectory + "SuperResolution/BlendHistory.comp", blendHistoryDefines);
+    if (enableSuperResolution && !enableNativeLRColor)
+    {
+        loadLRColorCS           = make_shared<ComputeShader>(resourcesDirectory + "IO/LoadLRColor.comp");
+    }
+    if (enableTileClassification)
+    {
+        classifyTilesCS         = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/ClassifyTiles.comp", geometryDefines);
+        compactTilesCS          = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/CompactTiles.comp");
+        copyCS_I                = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Copy_I.comp", copyDefines);
+    }
+    if (fillMode == FillMode::HoleList)
+    {
+        applyFillCS             = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/ApplyFill.comp");
+    }
+    if (fillMode == FillMode::PushPull)
+    {
+        pushFillCS              = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/PushFill.comp", frameGenerationDefines);
+        pullFillCS              = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/PullFill.comp", frameGenerationDefines);
+    }
+    if (reprojectionEngine == ReprojectionEngine::Gather)
+    {
+        reprojectGatherCS_I     = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/ReprojectGather_I.comp", frameGenerationDefines);
+    }
+    if (reprojectionEngine == ReprojectionEngine::RasterPoints || reprojectionEngine == ReprojectionEngine::RasterMesh)
+    {
+        std::vector<std::string> rasterDefines = geometryDefines;
+        if (reprojectionEngine == ReprojectionEngine::RasterMesh)
+        {
+            rasterDefines.push_back("ENABLE_RASTER_MESH");
+        }
+        reprojectRasterRS_I     = make_shared<RasterShader>(resourcesDirectory + "FrameGeneration/ReprojectRaster_I.vert",
+                                                            resourcesDirectory + "FrameGeneration/ReprojectRaster_I.frag", rasterDefines);
+    }
+    if (enablePacingSimulation && enableInterpolation)
+    {
+        // Extrapolation in the 32-bit format with a full fill, timed next to interpolation
+        std::vector<std::string> extrapolationFillDefines = geometryDefines;
+        extrapolationFillDefines.insert(extrapolationFillDefines.end(), neighborhoodDefines.begin(), neighborhoodDefines.end());
+        clearCS_E               = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Clear.comp", geometryDefines);
+        reprojectCS_E           = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Reproject_E.comp", geometryDefines);
+        fillCS_E                = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Fill.comp", extrapolationFillDefines);
+        warpCS_E                = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Warp_E.comp", warpDefines);
+        if (!clearCS_E->isValid() || !reprojectCS_E->isValid() || !fillCS_E->isValid() || !warpCS_E->isValid())
+        {
+            // A program that failed to build dispatches nothing, its passes would be timed as free
+            std::cout << "ERROR: Extrapolation passes failed to build, pacing simulation disabled" << std::endl;
+            enablePacingSimulation = false;
+        }
+    }
+    if (!enablePacingSimulation || !enableInterpolation)
+    {
+        clearCS_E = reprojectCS_E = fillCS_E = warpCS_E = nullptr;
+    }
+    if (enablePrecisionReport && !precisionDefine.empty())
+    {
+        warpReferenceCS_I       = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Warp_I.comp", warpReferenceDefines);
+        if (copyCS_I)
+        {
+            copyReferenceCS_I   = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Copy_I.comp");
+        }
+        if (warpCS_E)
+        {
+            warpReferenceCS_E   = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Warp_E.comp", warpReferenceDefines);
+        }
+        upsampleFirstFrameReferenceCS = make_shared<ComputeShader>(resourcesDirectory + "SuperResolution/UpsampleFirstFrame.comp");
+        blendHistoryReferenceCS = make_shared<ComputeShader>(resourcesDirectory + "SuperResolution/BlendHistory.comp", blendHistoryReferenceDefines);
+    }
+    if (reprojectionFormat == ReprojectionFormat::Wide64 && !useAtomicInt64)
+    {
+        // Second pass of the two-pass fallback: payload of the sources that won the depth test
+        reprojectDefines.push_back("REPROJECTION_PAYLOAD_PASS");
+        reprojectPayloadCS_I    = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Reproject_I.comp", reprojectDefines);
+    }
+    if (hashMode != HashMode::Off)
+    {
+        std::vector<std::string> hashDefines;
+        if (hashMode == HashMode::Tolerance)
+        {
+            hashDefines.push_back("HASH_PROJECTION");
+            resolveProjectionHashCS = make_shared<ComputeShader>(resourcesDirectory + "IO/HashTexture.comp", std::vector<std::string>{ "HASH_PROJECTION_RESOLVE" });
+        }
+        hashTextureCS           = make_shared<ComputeShader>(resourcesDirectory + "IO/HashTexture.comp", hashDefines);
+        hashUintTextureCS       = make_shared<ComputeShader>(resourcesDirectory + "IO/HashTexture.comp", std::vector<std::string>{ "HASH_UINT" });
+    }
+
+    
+    // Textures
+    if (enableSuperResolution && !enableNativeLRColor && !hasExternalInputs)
+    {
+        rawInputHRColor         = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_NEAREST);
+    }
+    else
+    {
+        rawInputHRColor         = nullptr;
+    }
+    if (!hasExternalInputs)
+    {
+        rawInputDepth           = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_NEAREST);
+        if (!enableCameraMotionVectors || enableSparseMotionVectors)
+        {
+            rawInputMotionVectorX = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_NEAREST);
+            rawInputMotionVectorY = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_NEAREST);
+        }
+
+        inputColor              = make_shared<Texture>(GL_RGBA8, renderWidth, renderHeight, GL_LINEAR);
+        inputDepth              = make_shared<Texture>(GL_R32F, renderWidth, renderHeight, GL_NEAREST);
+        inputMotionVector       = make_shared<Texture>(GL_RG16F, renderWidth, renderHeight, GL_NEAREST);
+    }
+
+    sampleLut                   = make_shared<Texture>(GL_R16F, 128, 128, GL_LINEAR);
+
+    // RG32UI keeps the R32F depth and the RG16F motion vector exact, RGBA16F would quantize depth
+    const GLenum dilatedDepthFormat = enableGeometryBuffer ? GL_RG32UI : GL_R32F;
+    currentDilatedDepth         = make_shared<Texture>(dilatedDepthFormat, renderWidth, renderHeight, GL_NEAREST);
+    if (!enableGeometryBuffer)
+    {
+        currentDilatedMotionVector = make_shared<Texture>(GL_RG16F, renderWidth, renderHeight, GL_NEAREST);
+    }
+    
+    if (enableInterpolation)
+    {
+        // Submitted colors are the HR colors of interpolation without super resolution
+        const bool isColorSubmitted = hasExternalInputs && !enableSuperResolution;
+        currentHRColor              = isColorSubmitted ? nullptr : make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+        previousDilatedDepth        = make_shared<Texture>(dilatedDepthFormat, renderWidth, renderHeight, GL_NEAREST);
+        if (!enableGeometryBuffer)
+        {
+            previousDilatedMotionVector = make_shared<Texture>(GL_RG16F, renderWidth, renderHeight, GL_NEAREST);
+        }
+        previousHRColor             = isColorSubmitted ? nullptr : make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+    }
+    else if (enableSuperResolution)
+    {
+        currentHRColor              = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+        previousDilatedDepth        = make_shared<Texture>(dilatedDepthFormat, renderWidth, renderHeight, GL_NEAREST);
+        previousDilatedMotionVector = nullptr;
+        previousHRColor             = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+    }
+    
+    // Filled reprojection holds (payload, depth) in the 64-bit format
+    const GLenum reprojectionTextureFormat = reprojectionFormat == ReprojectionFormat::Wide64 ? GL_RG32UI : GL_R32UI;
+    if (reprojectionFormat == ReprojectionFormat::Wide64)
+    {
+        reprojection            = nullptr;
+        wideReprojection        = make_shared<StorageBuffer>(renderWidth * renderHeight * 2 * sizeof(GLuint));
+    }
+    else
+    {
+        reprojection            = make_shared<Texture>(GL_R32UI, renderWidth, renderHeight, GL_NEAREST);
+    }
+    filledReprojection          = make_shared<Texture>(reprojectionTextureFormat, renderWidth, renderHeight, GL_NEAREST);
+    // Warp motion per LR pixel, packHalf2x16 mv_t1 and mv_t0 (8 bytes, the RG16F motion vectors stay exact)
+    resolvedMotion              = make_shared<Texture>(GL_RG32UI, renderWidth, renderHeight, GL_NEAREST);
+    frameGenerationResult       = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+    if (warpCS_E)
+    {
+        extrapolationReprojection       = make_shared<Texture>(GL_R32UI, renderWidth, renderHeight, GL_NEAREST);
+        extrapolationFilledReprojection = make_shared<Texture>(GL_R32UI, renderWidth, renderHeight, GL_NEAREST);
+        extrapolationResult             = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+    }
+
+    if (enableTileClassification)
+    {
+        // Flags are reset by CompactTiles after use, so they only need to start at zero
+        std::vector<GLuint> zeros(tileCountX * tileCountY, 0);
+        tileFlags               = make_shared<Texture>(GL_R32UI, tileCountX, tileCountY, GL_NEAREST);
+        tileFlags->loadFromMemory(zeros.data(), GL_RED_INTEGER, GL_UNSIGNED_INT);
+        // 9 indirect dispatch arguments followed by one entry per tile
+        tileList                = make_shared<StorageBuffer>((9 + tileCountX * tileCountY) * sizeof(GLuint));
+    }
+    if (fillMode == FillMode::HoleList)
+    {
+        // 3 indirect dispatch arguments and a count, followed by (position, value) per listed pixel
+        holeList                = make_shared<StorageBuffer>((4 + 2 * renderWidth * renderHeight) * sizeof(GLuint));
+        // One bit per LR pixel, cleared by Clear
+        holeMask                = make_shared<StorageBuffer>((renderWidth * renderHeight + 31) / 32 * sizeof(GLuint));
+    }
+    if (fillMode == FillMode::PushPull)
+    {
+        // Halve down to 1x1
+        int levelWidth = renderWidth;
+        int levelHeight = renderHeight;
+        while (levelWidth > 1 || levelHeight > 1)
+        {
+            levelWidth = (levelWidth + 1) / 2;
+            levelHeight = (levelHeight + 1) / 2;
+            pushPullLevels.push_back(make_shared<Texture>(reprojectionTextureFormat, levelWidth, levelHeight, GL_NEAREST));
+        }
+    }
+    if (enableReprojectionStats)
+    {
+        // Only Reproject_I uses binding 16
+        const GLuint zeros[3] = { 0, 0, 0 };
+        reprojectionStats       = make_shared<StorageBuffer>(sizeof(zeros), zeros);
+        reprojectionStats->bindBase(16);
+    }
+    reprojectionStatsFrameCount = 0;
+    if (warpReferenceCS_I)
+    {
+        precisionReference      = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_NEAREST);
+    }
+    precisionErrors.clear();
+    frameStatsSlots.clear();
+    frameStatsSlotIndex = 0;
+    dumpResourceNames.clear();
+    dumpReadbacks.clear();
+    pacingTimings.clear();
+    isTimingPasses = false;
+    dumpResourceNames = parseResourceNames(dumpResources, "dump");
+    if (enableFrameStats)
+    {
+        // Kernels write the counters of frame N while the host reads those of frame N - frameStatsLatency + 1
+        for (int i = 0; i < frameStatsLatency; i++)
+        {
+            FrameStatsSlot slot;
+            slot.counters = make_shared<StorageBuffer>(frameStatCount * sizeof(GLuint));
+            slot.fence = nullptr;
+            slot.outputFrame = 0;
+            frameStatsSlots.push_back(slot);
+        }
+        frameStatsFile.close();
+        frameStatsFile.clear();
+        frameStatsFile.open(outputDirectory + "stats.csv");
+        if (!frameStatsFile)
+        {
+            std::cout << "ERROR: Failed to open " << outputDirectory << "stats.csv" << std::endl;
+        }
+        frameStatsFile << "frame";
+        for (int i = 0; i < frameStatCount; i++)
+        {
+            frameStatsFile << "," << frameStatNames[i];
+        }
+        frameStatsFile << std::endl;
+    }
+    hashSlots.clear();
+    hashSlotIndex = 0;
+    hashResourceNames.clear();
+    goldenHashes.clear();
+    hashedFrameCount = 0;
+    divergedFrameCount = 0;
+    maxHashDifference = 0.0;
+    firstDivergence.clear();
+    if (hashMode != HashMode::Off)
+    {
+        hashResourceNames = parseResourceNames(hashResources, "hash");
+        for (int i = 0; i < hashLatency; i++)
+        {
+            HashSlot slot;
+            for (size_t j = 0; j <= hashResourceNames.size(); j++)
+            {
+                slot.hashes.push_back(make_shared<StorageBuffer>(hashBufferSize * sizeof(GLuint)));
+            }
+            slot.fence = nullptr;
+            slot.outputFrame = 0;
+            hashSlots.push_back(slot);
+        }
+        hashFile.close();
+        hashFile.clear();
+        hashFile.open(outputDirectory + "hashes.txt");
+        if (!hashFile)
+        {
+            std::cout << "ERROR: Failed to open " << outputDirectory << "hashes.txt" << std::endl;
+        }
+        if (hashMode == HashMode::Tolerance)
+        {
+            hashFile << "# projections" << std::endl;
+        }
+        else
+        {
+            hashFile << "# bitwise" << std::endl;
+        }
+        hashFile << "# frame texture hash" << std::endl;
+        if (!goldenHashPath.empty())
+        {
+            std::ifstream golden(goldenHashPath);
+            if (!golden)
+            {
+                std::cout << "ERROR: Failed to open golden hashes " << goldenHashPath << std::endl;
+            }
+            std::string line;
+            while (std::getline(golden, line))
+            {
+                if (line.empty() || line[0] == '#')
+                {
+                    continue;
+                }
+                std::istringstream ss(line);
+                int frame;
+                std::string name;
+                unsigned long long hash;
+                if (ss >> frame >> name >> std::hex >> hash)
+                {
+                    goldenHashes[std::make_pair(frame, name)] = hash;
+                }
+            }
+        }
+    }
+    if (reprojectRasterRS_I)
+    {
+        glGenRenderbuffers(1, &reprojectionDepthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, reprojectionDepthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, renderWidth, renderHeight);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &reprojectionFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, reprojectionFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, reprojection->getID(), 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, reprojectionDepthBuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << "ERROR: Reprojection framebuffer is incomplete" << std::endl;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // No attributes, but core profiles need a vertex array object to draw
+        glGenVertexArrays(1, &reprojectionVertexArray);
+        glBindVertexArray(reprojectionVertexArray);
+        reprojectionIndexCount = 0;
+        if (reprojectionEngine == ReprojectionEngine::RasterMesh)
+        {
+            // Vertex index = y * renderWidth + x, one strip per pair of rows
+            std::vector<GLuint> indices;
+            indices.reserve((renderHeight - 1) * (2 * renderWidth + 1));
+            for (int y = 0; y + 1 < renderHeight; y++)
+            {
+                for (int x = 0; x < renderWidth; x++)
+                {
+                    indices.push_back(static_cast<GLuint>(y * renderWidth + x));
+                    indices.push_back(static_cast<GLuint>((y + 1) * renderWidth + x));
+                }
+                indices.push_back(0xFFFFFFFFu);
+            }
+            reprojectionIndexCount = static_cast<int>(indices.size());
+            glGenBuffers(1, &reprojectionIndexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, reprojectionIndexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        }
+        glBindVertexArray(0);
+    }
+
+    // LUTs
+    sampleLut->loadLUT(resourcesDirectory + "lut.exr");
+
+    if (enableCameraMotionVectors)
+    {
+        constexpr int cameraBlockBindingPoint = 15;
+        glGenBuffers(1, &cameraBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, cameraBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, cameraBlockBindingPoint, cameraBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
+void OffscreenRenderer::execute()
+{
+    if (backend != Backend::OpenGL && !cpuBackend)
+    {
+        initializeCPU();
+    }
+    if (requiresOpenGL())
+    {
+        initializeOpenGL();
+    }
+    validationMaxDiff = 0;
+    validationMinPSNR = std::numeric_limits<double>::infinity();
+    if (!enableInterpolation)
+    {
+        generatedFramesCount = 0;
+    }
+    currentOutputFrame = 0;
+    isFirstCycleCompleted = false;
+    jitterOffsetIndex = 0;
+    for (currentInputFrame = startInputFrame; currentInputFrame < endInputFrame; currentInputFrame++)
+    {
+        // Load rendered frame
+        load();
+        for (int cycleFrameIndex = 0; cycleFrameIndex < generatedFramesCount + 1; cycleFrameIndex++, currentOutputFrame++)
+        {
+            renderOutputFrame(cycleFrameIndex);
+            save();
+        }
+        finishInputFrame();
+    }
+    endFrames();
+}
+
+bool OffscreenRenderer::beginFrames()
+{
+    if (!hasExternalInputs || backend != Backend::OpenGL)
+    {
+        std::cout << "ERROR: Submitted frames need an OffscreenRenderer with external inputs and Backend::OpenGL" << std::endl;
+        return false;
+    }
+    if (!hasBegunFrames)
+    {
+        initializeOpenGL();
+        hasBegunFrames = true;
+    }
+    if (!enableInterpolation)
+    {
+        generatedFramesCount = 0;
+    }
+    currentInputFrame = startInputFrame;
+    currentOutputFrame = 0;
+    isFirstCycleCompleted = false;
+    submittedFrameCount = 0;
+    receiveCycleFrameIndex = 0;
+    cycleOutputFrame = 0;
+    return true;
+}
+
+bool OffscreenRenderer::submitFrame(GLuint color, GLuint depth, GLuint motionVector, float jitterX, float jitterY)
+{
+    // Only the names change between frames of double-buffered inputs
+    auto wrap = [](shared_ptr<Texture>& texture, GLuint name)
+    {
+        if (!texture || texture->getID() != name)
+        {
+            texture = make_shared<Texture>(name);
+        }
+    };
+    wrap(inputColor, color);
+    wrap(inputDepth, depth);
+    wrap(inputMotionVector, motionVector);
+    const shared_ptr<Texture> inputs[] = { inputColor, inputDepth, inputMotionVector };
+    for (const shared_ptr<Texture>& input : inputs)
+    {
+        if (input->getWidth() != renderWidth || input->getHeight() != renderHeight)
+        {
+            std::cout << "ERROR: Submitted texture " << input->getID() << " is " << input->getWidth() << "x" << input->getHeight()
+                << ", expected " << renderWidth << "x" << renderHeight << std::endl;
+            return false;
+        }
+    }
+    if (inputColor->getFormat() != GL_RGBA8)
+    {
+        std::cout << "ERROR: Submitted color texture " << color << " is not GL_RGBA8" << std::endl;
+        return false;
+    }
+    if (enableInterpolation && !enableSuperResolution && currentHRColor && currentHRColor->getID() == color)
+    {
+        // The last submitted color is interpolated from until this frame is rendered
+        std::cout << "ERROR: Submitted color texture " << color << " is still the last frame, alternate between two textures" << std::endl;
+        return false;
+    }
+
+    if (submittedFrameCount > 0)
+    {
+        // Generated frames that were not received still count
+        currentOutputFrame = cycleOutputFrame + generatedFramesCount + 1;
+        finishInputFrame();
+        currentInputFrame++;
+    }
+    submittedFrameCount++;
+    externalJitterOffset = vec2(jitterX, jitterY);
+    cycleOutputFrame = currentOutputFrame;
+    renderOutputFrame(0);
+    receiveCycleFrameIndex = 0;
+    return true;
+}
+
+bool OffscreenRenderer::setOutputTextures(const std::vector<GLuint>& historyTextures, const std::vector<GLuint>& generatedTextures)
+{
+    if (submittedFrameCount > 0)
+    {
+        std::cout << "ERROR: Output textures are set before the first submitted frame" << std::endl;
+        return false;
+    }
+    if (!historyTextures.empty() && (historyTextures.size() != 2 || !enableSuperResolution))
+    {
+        std::cout << "ERROR: Two history textures are set with super resolution only" << std::endl;
+        return false;
+    }
+    std::vector<shared_ptr<Texture>> history;
+    std::vector<shared_ptr<Texture>> generated;
+    for (GLuint name : historyTextures)
+    {
+        history.push_back(make_shared<Texture>(name));
+    }
+    for (GLuint name : generatedTextures)
+    {
+        generated.push_back(make_shared<Texture>(name));
+    }
+    for (const std::vector<shared_ptr<Texture>>* textures : { &history, &generated })
+    {
+        for (const shared_ptr<Texture>& texture : *textures)
+        {
+            // Written as rgba8 images
+            if (texture->getFormat() != GL_RGBA8 || texture->getWidth() != presentationWidth || texture->getHeight() != presentationHeight)
+            {
+                std::cout << "ERROR: Output texture " << texture->getID() << " is not GL_RGBA8 of " << presentationWidth << "x"
+                    << presentationHeight << std::endl;
+                return false;
+            }
+        }
+    }
+    if (!history.empty())
+    {
+        currentHRColor = history[0];
+        previousHRColor = history[1];
+    }
+    if (!generated.empty())
+    {
+        generatedOutputs = generated;
+        generatedOutputIndex = 0;
+        frameGenerationResult = generatedOutputs[0];
+    }
+    return true;
+}
+
+shared_ptr<Texture> OffscreenRenderer::receiveFrame()
+{
+    if (submittedFrameCount == 0 || receiveCycleFrameIndex > generatedFramesCount)
+    {
+        return nullptr;
+    }
+    if (receiveCycleFrameIndex > 0)
+    {
+        currentOutputFrame = cycleOutputFrame + receiveCycleFrameIndex;
+        renderOutputFrame(receiveCycleFrameIndex);
+    }
+    receiveCycleFrameIndex++;
+    return isFinalOutput() ? outputColor : nullptr;
+}
+
+void OffscreenRenderer::renderOutputFrame(int cycleFrameIndex)
+{
+    if (cycleFrameIndex == 0)
+    {
+        // Rendered frame
+        isRenderedFrame = true;
+        isGeneratedFrame = false;
+
+        if (hasExternalInputs)
+        {
+            jitterOffset = externalJitterOffset;
+        }
+        else if (enableNativeLRColor)
+        {
+            auto jitter = jitterOffsets.find(currentInputFrame);
+            if (jitter == jitterOffsets.end())
+            {
+                std::cout << "ERROR: No jitter offset for frame " << currentInputFrame << " in " << inputLrJitterPath << std::endl;
+            }
+            jitterOffset = jitter != jitterOffsets.end() ? jitter->second : vec2();
+        }
+        else
+        {
+            jitterOffset = jitterSequence[jitterOffsetIndex];
+            jitterOffsetIndex = (jitterOffsetIndex + 1) % jitterSequenceLength;
+        }
+        if (enableCameraMotionVectors)
+        {
+            updateCameraBlock();
+        }
+    }
+    else
+    {
+        // Generated frame
+        isRenderedFrame = false;
+        isGeneratedFrame = true;
+        if (!generatedOutputs.empty() && isFirstCycleCompleted)
+        {
+            frameGenerationResult = generatedOutputs[generatedOutputIndex];
+            generatedOutputIndex = (generatedOutputIndex + 1) % generatedOutputs.size();
+        }
+    }
+    
+    delta = static_cast<float>(cycleFrameIndex) / static_cast<float>(generatedFramesCount + 1);
+    
+    render();
+}
+
+void OffscreenRenderer::finishInputFrame()
+{
+    if (!isFirstCycleCompleted)
+    {
+        if (enableInterpolation)
+        {
+            outputColor = nullptr;
+            cpuOutputColor = nullptr;
+            currentOutputFrame = 0;
+        }
+        isFirstCycleCompleted = true;
+    }
+}
+
+void OffscreenRenderer::endFrames()
+{
+    if (reprojectionStats && reprojectionStatsFrameCount > 0)
+    {
+        GLuint stats[3];
+        reprojectionStats->getData(0, sizeof(stats), stats);
+        const GLuint frameCount = static_cast<GLuint>(reprojectionStatsFrameCount);
+        std::cout << "Reprojection per frame: " << stats[0] / frameCount << " atomic requests, "
+            << stats[1] / frameCount << " global atomics, " << stats[2] / frameCount << " contended" << std::endl;
+    }
+    for (int i = 0; i < static_cast<int>(frameStatsSlots.size()); i++)
+    {
+        FrameStatsSlot& slot = frameStatsSlots[(frameStatsSlotIndex + i) % frameStatsSlots.size()];
+        if (slot.fence)
+        {
+            readFrameStats(slot, true);
+        }
+    }
+    if (frameStatsFile.is_open())
+    {
+        frameStatsFile.close();
+    }
+    writeDumps(true);
+    for (int i = 0; i < static_cast<int>(hashSlots.size()); i++)
+    {
+        HashSlot& slot = hashSlots[(hashSlotIndex + i) % hashSlots.size()];
+        if (slot.fence)
+        {
+            readHashes(slot, true);
+        }
+    }
+    if (hashFile.is_open())
+    {
+        hashFile.close();
+        if (goldenHashPath.empty())
+        {
+            std::cout << "Hashes: " << hashedFrameCount << " frames written to " << outputDirectory << "hashes.txt" << std::endl;
+        }
+        else if (divergedFrameCount == 0)
+        {
+            std::cout << "Hashes: " << hashedFrameCount << " frames match " << goldenHashPath;
+            if (hashMode == HashMode::Tolerance)
+            {
+                std::cout << " (RMS difference up to ~" << maxHashDifference << ")";
+            }
+            std::cout << std::endl;
+        }
+        else
+        {
+            std::cout << "Hashes: " << divergedFrameCount << " of " << hashedFrameCount << " frames differ from " << goldenHashPath
+                << ", first divergence: " << firstDivergence << std::endl;
+        }
+    }
+    if (enablePacingSimulation && requiresOpenGL())
+    {
+        reportPacing();
+    }
+    if (enableDispatchOrderBenchmark && requiresOpenGL() && enableInterpolation && isFirstCycleCompleted)
+    {
+        benchmarkDispatchOrders();
+    }
+    for (const auto& error : precisionErrors)
+    {
+        const double psnr = error.second.squaredErrorSum > 0.0 ?
+            10.0 * std::log10(255.0 * 255.0 * error.second.valueCount / error.second.squaredErrorSum) : std::numeric_limits<double>::infinity();
+        std::cout << "FP16 vs FP32 " << error.first << ": max diff " << error.second.maxDiff << ", PSNR " << psnr
+            << " dB (min per frame " << error.second.minPSNR << " dB)" << std::endl;
+    }
+    if (backend == Backend::Validate)
+    {
+        std::cout << "Validation: max diff " << validationMaxDiff << ", min PSNR " << validationMinPSNR << " dB" << std::endl;
+    }
+}
+
+void OffscreenRenderer::loadJitterOffsets()
+{
+    // One line per input frame: frame number, then the x and y jitter offset in LR pixels (sign as in jitterSequence:
+    // LR pixel p was rendered at p + 0.5 - offset). Empty lines and lines starting with '#' are skipped.
+    std::ifstream file(inputLrJitterPath);
+    if (!file)
+    {
+        std::cout << "ERROR: Failed to open jitter offsets " << inputLrJitterPath << std::endl;
+        return;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream ss(line);
+        int frame;
+        vec2 offset;
+        if (!(ss >> frame >> offset.x >> offset.y))
+        {
+            std::cout << "ERROR: Invalid jitter offset line \"" << line << "\" in " << inputLrJitterPath << std::endl;
+            continue;
+        }
+        jitterOffsets[frame] = offset;
+    }
+}
+
+void OffscreenRenderer::loadViewProjections()
+{
+    // One line per input frame: frame number, then the 16 values of the view-projection matrix (world -> OpenGL clip
+    // space) row by row. Empty lines and lines starting with '#' are skipped.
+    std::ifstream file(inputCameraMatrixPath);
+    if (!file)
+    {
+        std::cout << "ERROR: Failed to open camera matrices " << inputCameraMatrixPath << std::endl;
+        return;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream ss(line);
+        int frame;
+        mat4 viewProjection;
+        bool valid = static_cast<bool>(ss >> frame);
+        for (int i = 0; i < 16 && valid; i++)
+        {
+            // Row-major in the file, column-major in memory
+            valid = static_cast<bool>(ss >> viewProjection.m[(i % 4) * 4 + i / 4]);
+        }
+        if (!valid)
+        {
+            std::cout << "ERROR: Invalid camera matrix line \"" << line << "\" in " << inputCameraMatrixPath << std::endl;
+            continue;
+        }
+        viewProjections[frame] = viewProjection;
+    }
+}
+
+void OffscreenRenderer::updateCameraBlock()
+{
+    // Without a previous matrix (first input frame) the camera stands still
+    auto current = viewProjections.find(currentInputFrame);
+    auto previous = viewProjections.find(currentInputFrame - 1);
+    mat4 inverseViewProjection;
+    if (current == viewProjections.end() || !invert(current->second, inverseViewProjection))
+    {
+        std::cout << "ERROR: No invertible camera matrix for frame " << currentInputFrame << " in " << inputCameraMatrixPath << std::endl;
+        cameraBlock.reprojection = getIdentity();
+        return;
+    }
+    const mat4& previousViewProjection = previous != viewProjections.end() ? previous->second : current->second;
+
+    // Depth was rendered at the jittered pixel center p + 0.5 - jitterOffset, the motion vector starts at p + 0.5
+    mat4 jitter = getIdentity();
+    if (enableSuperResolution)
+    {
+        jitter.m[12] = -2.0f * jitterOffset.x / static_cast<float>(renderWidth);
+        jitter.m[13] = 2.0f * jitterOffset.y / static_cast<float>(renderHeight);
+    }
+    cameraBlock.reprojection = multiply(previousViewProjection, multiply(inverseViewProjection, jitter));
+}
+
+void OffscreenRenderer::load()
+{
+    // Load textures
+    std::stringstream ss;
+    ss << std::setw(4) << std::setfill('0') << currentInputFrame << ".png";
+    std::string fileName = ss.str();
+
+    std::string colorDirectory = enableNativeLRColor ? inputLrColorDirectory : inputHrColorDirectory;
+    std::string depthDirectory = enableSuperResolution ? inputLrDepthDirectory : inputHrDepthDirectory;
+    std::string motionVectorXDirectory = enableSuperResolution ? inputLrMotionVectorXDirectory : inputHrMotionVectorXDirectory;
+    std::string motionVectorYDirectory = enableSuperResolution ? inputLrMotionVectorYDirectory : inputHrMotionVectorYDirectory;
+    if (cpuBackend)
+    {
+        cpuBackend->load(colorDirectory + fileName, depthDirectory + fileName, motionVectorXDirectory + fileName, motionVectorYDirectory + fileName);
+    }
+    if (!requiresOpenGL())
+    {
+        return;
+    }
+
+    auto loadTexture = [this](Texture& texture, const std::string& path, GLenum sourceFormat, GLenum sourceType)
+    {
+        if (inputCache)
+        {
+            inputCache->load(texture, path, sourceFormat, sourceType);
+        }
+        else
+        {
+            texture.loadFromFile(path, sourceFormat, sourceType);
+        }
+    };
+    GLenum sourceFormat = GL_RGB;
+    GLenum sourceType = GL_UNSIGNED_BYTE;
+    if(!enableSuperResolution || enableNativeLRColor)
+    {
+        loadTexture(*inputColor, colorDirectory + fileName, sourceFormat, sourceType);
+    }
+    else
+    {
+        loadTexture(*rawInputHRColor, colorDirectory + fileName, sourceFormat, sourceType);
+    }
+    
+    sourceFormat = GL_RGBA;
+    loadTexture(*rawInputDepth, depthDirectory + fileName, sourceFormat, sourceType);
+    if (rawInputMotionVectorX)
+    {
+        loadTexture(*rawInputMotionVectorX, motionVectorXDirectory + fileName, sourceFormat, sourceType);
+        loadTexture(*rawInputMotionVectorY, motionVectorYDirectory + fileName, sourceFormat, sourceType);
+    }
+}
+
+void OffscreenRenderer::render()
+{
+    if (cpuBackend)
+    {
+        renderCPU();
+    }
+    if (requiresOpenGL())
+    {
+        renderOpenGL();
+    }
+}
+
+void OffscreenRenderer::renderOpenGL()
+{
+    bindUniformBuffer();
+    if (!frameStatsSlots.empty())
+    {
+        beginFrameStats();
+    }
+    if (isTimingFrames() && isFirstCycleCompleted)
+    {
+        beginPacingTiming();
+    }
+
+    if (isRenderedFrame)
+    {
+        swapBuffers();
+        processInputs();
+        preprocess();
+
+        if (enableSuperResolution)
+        {
+            if (!isFirstCycleCompleted)
+            {
+                // First frame
+                upsampleFirstFrame();
+                outputColor = currentHRColor;
+            }
+            else
+            {
+                superSample();
+                outputColor = currentHRColor;
+            }
+        }
+        if (enableInterpolation && isFirstCycleCompleted)
+        {
+            outputColor = previousHRColor;
+        }
+    }
+    else if (isGeneratedFrame)
+    {
+        if (enableInterpolation && isFirstCycleCompleted)
+        {
+            if (enableTileClassification)
+            {
+                interpolateTiled();
+            }
+            else
+            {
+                interpolate();
+            }
+            if (warpCS_E)
+            {
+                extrapolate();
+            }
+            reprojectionStatsFrameCount++;
+            outputColor = frameGenerationResult;
+        }
+    }
+    if (isTimingFrames() && isFirstCycleCompleted)
+    {
+        endPacingTiming();
+    }
+    if (!frameStatsSlots.empty())
+    {
+        endFrameStats();
+    }
+    if (!dumpResourceNames.empty())
+    {
+        dumpFrame();
+    }
+    if (!hashSlots.empty())
+    {
+        hashFrame();
+    }
+}
+
+void OffscreenRenderer::renderCPU()
+{
+    // Same flow as renderOpenGL()
+    UniformBlock uniformBlock = getUniformBlock();
+    cpuExtrapolationColor = nullptr;
+
+    if (isRenderedFrame)
+    {
+        cpuBackend->swapBuffers();
+        cpuBackend->processInputs(uniformBlock, cameraBlock);
+        cpuBackend->preprocess();
+
+        if (enableSuperResolution)
+        {
+            if (!isFirstCycleCompleted)
+            {
+                // First frame
+                cpuBackend->upsampleFirstFrame(uniformBlock);
+            }
+            else
+            {
+                cpuBackend->superSample(uniformBlock);
+            }
+            cpuOutputColor = cpuBackend->getCurrentHRColor();
+        }
+        if (enableInterpolation && isFirstCycleCompleted)
+        {
+            cpuOutputColor = cpuBackend->getPreviousHRColor();
+        }
+    }
+    else if (isGeneratedFrame)
+    {
+        if (enableInterpolation && isFirstCycleCompleted)
+        {
+            cpuBackend->interpolate(uniformBlock);
+            if (warpCS_E)
+            {
+                cpuBackend->extrapolate(uniformBlock);
+                cpuExtrapolationColor = cpuBackend->getExtrapolationResult();
+            }
+            cpuOutputColor = cpuBackend->getFrameGenerationResult();
+        }
+    }
+}
+
+void OffscreenRenderer::save()
+{
+    std::stringstream ss;
+    ss << std::setw(4) << std::setfill('0') << currentOutputFrame << ".png";
+    std::string fileName = ss.str();
+
+    if (backend == Backend::CPU)
+    {
+        if (cpuOutputColor)
+        {
+            cpuOutputColor->saveAsPNG((outputDirectory + fileName).c_str());
+        }
+        return;
+    }
+
+    if (!outputColor)
+    {
+        return;
+    }
+    if (outputCallback)
+    {
+        if (isFinalOutput())
+        {
+            outputCallback(currentOutputFrame, *outputColor);
+        }
+        return;
+    }
+
+    outputColor->saveAsPNG((outputDirectory + fileName).c_str(), 4);
+
+    if (backend == Backend::Validate)
+    {
+        validate();
+    }
+}
+
+void OffscreenRenderer::validate()
+{
+    if (!cpuOutputColor)
+    {
+        std::cout << "Frame " << currentOutputFrame << ": no CPU output" << std::endl;
+        return;
+    }
+    validate("", *outputColor, *cpuOutputColor);
+    if (cpuExtrapolationColor)
+    {
+        validate(" extrapolation", *extrapolationResult, *cpuExtrapolationColor);
+    }
+}
+
+void OffscreenRenderer::validate(const std::string& label, const Texture& result, const CpuImage& cpuResult)
+{
+    std::vector<unsigned char> expected(static_cast<size_t>(result.getWidth()) * result.getHeight() * 4);
+    result.getImage(GL_RGBA, GL_UNSIGNED_BYTE, expected.data());
+    std::vector<unsigned char> actual;
+    cpuResult.getRGBA8(actual);
+
+    // RGB only, alpha is always 1
+    int maxDiff = 0;
+    size_t exceedingCount = 0;
+    double squaredErrorSum = 0.0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (i % 4 == 3)
+        {
+            continue;
+        }
+        const int diff = std::abs(static_cast<int>(expected[i]) - static_cast<int>(actual[i]));
+        maxDiff = std::max(maxDiff, diff);
+        exceedingCount += diff > validationTolerance ? 1 : 0;
+        squaredErrorSum += static_cast<double>(diff * diff);
+    }
+    const double meanSquaredError = squaredErrorSum / static_cast<double>(expected.size() / 4 * 3);
+    const double psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : std::numeric_limits<double>::infinity();
+    validationMaxDiff = std::max(validationMaxDiff, maxDiff);
+    validationMinPSNR = std::min(validationMinPSNR, psnr);
+
+    std::cout << "Frame " << currentOutputFrame << label << ": max diff " << maxDiff << ", " << exceedingCount
+        << " values above " << validationTolerance << ", PSNR " << psnr << " dB" << std::endl;
+}
+
+void OffscreenRenderer::reportPrecision(const std::string& kernel, const Texture& result)
+{
+    std::vector<unsigned char> expected(static_cast<size_t>(presentationWidth) * presentationHeight * 4);
+    std::vector<unsigned char> actual(expected.size());
+    precisionReference->getImage(GL_RGBA, GL_UNSIGNED_BYTE, expected.data());
+    result.getImage(GL_RGBA, GL_UNSIGNED_BYTE, actual.data());
+
+    // RGB only, like validate()
+    int maxDiff = 0;
+    double squaredErrorSum = 0.0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (i % 4 == 3)
+        {
+            continue;
+        }
+        const int diff = std::abs(static_cast<int>(expected[i]) - static_cast<int>(actual[i]));
+        maxDiff = std::max(maxDiff, diff);
+        squaredErrorSum += static_cast<double>(diff * diff);
+    }
+    const double valueCount = static_cast<double>(expected.size() / 4 * 3);
+    const double psnr = squaredErrorSum > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * valueCount / squaredErrorSum) : std::numeric_limits<double>::infinity();
+
+    auto error = precisionErrors.find(kernel);
+    if (error == precisionErrors.end())
+    {
+        error = precisionErrors.insert(std::make_pair(kernel, PrecisionError { 0, 0.0, 0.0, std::numeric_limits<double>::infinity() })).first;
+    }
+    error->second.maxDiff = std::max(error->second.maxDiff, maxDiff);
+    error->second.squaredErrorSum += squaredErrorSum;
+    error->second.valueCount += valueCount;
+    error->second.minPSNR = std::min(error->second.minPSNR, psnr);
+}
+
+UniformBlock OffscreenRenderer::getUniformBlock() const
+{
+    UniformBlock uniformBlock;
+    uniformBlock.render_size.x = static_cast<float>(renderWidth);
+    uniformBlock.render_size.y = static_cast<float>(renderHeight);
+    uniformBlock.render_size.z = 1.0f / static_cast<float>(renderWidth);
+    uniformBlock.render_size.w = 1.0f / static_cast<float>(renderHeight);
+    uniformBlock.presentation_size.x = static_cast<float>(presentationWidth);
+    uniformBlock.presentation_size.y = static_cast<float>(presentationHeight);
+    uniformBlock.presentation_size.z = 1.0f / static_cast<float>(presentationWidth);
+    uniformBlock.presentation_size.w = 1.0f / static_cast<float>(presentationHeight);
+    uniformBlock.delta.x = delta;
+    uniformBlock.delta.y = delta * 0.5f;
+    uniformBlock.delta.z = delta * 1.5f;
+    uniformBlock.delta.w = delta * delta * 0.5f;
+    uniformBlock.jitter_offset.x = jitterOffset.x;
+    uniformBlock.jitter_offset.y = jitterOffset.y;
+    uniformBlock.depth_diff_threshold_sr = depthDiffThresholdSR;
+    uniformBlock.color_diff_threshold_fg = colorDiffThresholdFG;
+    uniformBlock.depth_diff_threshold_fg = depthDiffThresholdFG;
+    uniformBlock.depth_scale = depthScale;
+    uniformBlock.depth_bias = depthBias;
+    uniformBlock.render_scale = upsampleScale;
+    return uniformBlock;
+}
+
+void OffscreenRenderer::bindUniformBuffer()
+{
+    /*
+    layout (binding = 10, std140) uniform cb_t
+    {
+                                        offset  size
+        vec4 render_size;               0       16
+        vec4 presentation_size;         16      16
+        vec4 delta;                     32      16  
+        vec2 jitter_offset;             48      8
+        float depth_diff_threshold_sr;  56      4  
+        float color_diff_threshold_fg;  60      4
+        float depth_diff_threshold_fg;  64      4
+        float depth_scale;              68      4
+        float depth_bias;               72      4
+        float render_scale;             76      4
+    };
+    // size = 80
+    */
+
+    UniformBlock uniformBlock = getUniformBlock();
+    
+    constexpr int uniformBlockBindingPoint = 10;
+    constexpr int uniformBlockSize = sizeof(UniformBlock);
+    
+    if (!uniformBuffer)
+    {
+        glGenBuffers(1, &uniformBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, uniformBlockSize, nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+    glBindBufferRange(GL_UNIFORM_BUFFER, uniformBlockBindingPoint, uniformBuffer, 0, uniformBlockSize);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, uniformBlockSize, &uniformBlock);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void OffscreenRenderer::swapBuffers()
+{
+    if (enableInterpolation)
+    {
+        std::swap(currentHRColor, previousHRColor);
+        std::swap(currentDilatedDepth, previousDilatedDepth);
+        std::swap(currentDilatedMotionVector, previousDilatedMotionVector);
+    }
+    else 
+    {
+        if (enableSuperResolution)
+        {
+            std::swap(currentHRColor, previousHRColor);
+            std::swap(currentDilatedDepth, previousDilatedDepth);
+        }
+    }
+}
+
+void OffscreenRenderer::bindGeometry(int currentDepthUnit, int currentMotionVectorUnit, int previousDepthUnit, int previousMotionVectorUnit)
+{
+    if (enableGeometryBuffer)
+    {
+        const int currentUnit = currentDepthUnit >= 0 ? currentDepthUnit : currentMotionVectorUnit;
+        const int previousUnit = previousDepthUnit >= 0 ? previousDepthUnit : previousMotionVectorUnit;
+        if (currentUnit >= 0)
+        {
+            currentDilatedDepth->bindTexture(currentUnit);
+        }
+        if (previousUnit >= 0)
+        {
+            previousDilatedDepth->bindTexture(previousUnit);
+        }
+        return;
+    }
+    if (currentDepthUnit >= 0)
+    {
+        currentDilatedDepth->bindTexture(currentDepthUnit);
+    }
+    if (currentMotionVectorUnit >= 0)
+    {
+        currentDilatedMotionVector->bindTexture(currentMotionVectorUnit);
+    }
+    if (previousDepthUnit >= 0)
+    {
+        previousDilatedDepth->bindTexture(previousDepthUnit);
+    }
+    if (previousMotionVectorUnit >= 0)
+    {
+        previousDilatedMotionVector->bindTexture(previousMotionVectorUnit);
+    }
+}
+
+void OffscreenRenderer::processInputs()
+{
+    if (hasExternalInputs)
+    {
+        // Submitted textures are read in place
+        return;
+    }
+
+    // Decode depths
+    loadDepthCS->use();
+    rawInputDepth->bindTexture(0);
+    inputDepth->bindImageUnit(1, GL_WRITE_ONLY);
+    loadDepthCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("LoadDepth");
+
+    if (enableCameraMotionVectors)
+    {
+        // Reconstruct motion vectors from the decoded depths
+        glBindBuffer(GL_UNIFORM_BUFFER, cameraBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &cameraBlock);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        reconstructMotionVectorCS->use();
+        inputDepth->bindTexture(0);
+        if (enableSparseMotionVectors)
+        {
+            rawInputMotionVectorX->bindTexture(1);
+            rawInputMotionVectorY->bindTexture(2);
+        }
+        inputMotionVector->bindImageUnit(3, GL_WRITE_ONLY);
+        reconstructMotionVectorCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+        endPacingPass("ReconstructMotionVector");
+    }
+    else
+    {
+        // Decode motion vectors
+        loadMotionVectorCS->use();
+        rawInputMotionVectorX->bindTexture(0);
+        rawInputMotionVectorY->bindTexture(1);
+        inputMotionVector->bindImageUnit(2, GL_WRITE_ONLY);
+        loadMotionVectorCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+        endPacingPass("LoadMotionVector");
+    }
+
+    // Sample HR color with jittered position to generate LR color
+    if (enableSuperResolution && !enableNativeLRColor)
+    {
+        loadLRColorCS->use();
+        rawInputHRColor->bindTexture(0);
+        inputColor->bindImageUnit(1, GL_WRITE_ONLY);
+        loadLRColorCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+        endPacingPass("LoadLRColor");
+    }
+}
+
+void OffscreenRenderer::preprocess()
+{
+    // Dilate
+    dilateCS->use();
+    inputDepth->bindTexture(0);
+    inputMotionVector->bindTexture(1);
+    currentDilatedDepth->bindImageUnit(2, GL_WRITE_ONLY);
+    if (!enableGeometryBuffer)
+    {
+        currentDilatedMotionVector->bindImageUnit(3, GL_WRITE_ONLY);
+    }
+    dilateCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("Dilate");
+
+    // Copy inputColor -> currentHRColor, submitted colors are kept until the next frame instead
+    if (enableInterpolation && !enableSuperResolution)
+    {
+        if (hasExternalInputs)
+        {
+            currentHRColor = inputColor;
+        }
+        else
+        {
+            currentHRColor->copyFrom(*inputColor, renderWidth, renderHeight);
+            endPacingPass("CopyColor");
+        }
+    }
+}
+
+void OffscreenRenderer::interpolate()
+{
+    shared_ptr<Texture> warpInput = filledReprojection;
+    if (reprojectionEngine == ReprojectionEngine::Gather)
+    {
+        // Writes filledReprojection in one pass
+        reprojectGatherCS_I->use();
+        bindGeometry(0, 1, -1, 2);
+        filledReprojection->bindImageUnit(3, GL_WRITE_ONLY);
+        reprojectGatherCS_I->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+        endPacingPass("ReprojectGather_I");
+    }
+    else
+    {
+        if (fillMode == FillMode::HoleList)
+        {
+            const GLuint holeListHeader[4] = { 0, 1, 1, 0 };
+            holeList->setData(0, sizeof(holeListHeader), holeListHeader);
+            holeList->bindBase(12);
+            holeMask->bindBase(13);
+            holeList->bindIndirect();
+        }
+        // The 64-bit format reprojects into a storage buffer instead of the reprojection texture
+        if (reprojectionFormat == ReprojectionFormat::Wide64)
+        {
+            wideReprojection->bindBase(14);
+        }
+
+        if (reprojectRasterRS_I)
+        {
+            // Clears as well
+            reprojectRaster();
+            endPacingPass("ReprojectRaster_I");
+        }
+        else
+        {
+            clearCS->use();
+            if (reprojection)
+            {
+                reprojection->bindImageUnit(0, GL_WRITE_ONLY);
+            }
+            clearCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+            endPacingPass("Clear");
+        
+            reprojectCS_I->use();
+            bindGeometry(0, 1, -1, 2);
+            if (reprojection)
+            {
+                reprojection->bindImageUnit(3, GL_READ_WRITE);
+            }
+            reprojectCS_I->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+            endPacingPass("Reproject_I");
+            if (reprojectPayloadCS_I)
+            {
+                reprojectPayloadCS_I->use();
+                reprojectPayloadCS_I->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+                endPacingPass("ReprojectPayload_I");
+            }
+        }
+    
+        if (fillMode == FillMode::HoleList)
+        {
+            // Fill listed pixels only and write them back into reprojection
+            fillCS->use();
+            reprojection->bindTexture(0);
+            fillCS->dispatchIndirect(0);
+            endPacingPass("Fill");
+        
+            applyFillCS->use();
+            reprojection->bindImageUnit(0, GL_WRITE_ONLY);
+            applyFillCS->dispatchIndirect(0);
+            endPacingPass("ApplyFill");
+            warpInput = reprojection;
+        }
+        else
+        {
+            fillCS->use();
+            if (reprojection)
+            {
+                reprojection->bindTexture(0);
+            }
+            filledReprojection->bindImageUnit(1, GL_WRITE_ONLY);
+            fillCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+            endPacingPass("Fill");
+        }
+    }
+    if (fillMode == FillMode::PushPull)
+    {
+        pushPullFill();
+        endPacingPass("PushPullFill");
+    }
+    
+    resolveMotionCS_I->use();
+    warpInput->bindTexture(0);
+    bindGeometry(-1, 1, -1, 2);
+    resolvedMotion->bindImageUnit(3, GL_WRITE_ONLY);
+    resolveMotionCS_I->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("ResolveMotion_I");
+    
+    warpCS_I->use();
+    resolvedMotion->bindTexture(0);
+    currentHRColor->bindTexture(1);
+    previousHRColor->bindTexture(2);
+    bindGeometry(3, -1, 4, -1);
+    frameGenerationResult->bindImageUnit(7, GL_WRITE_ONLY);
+    sampleLut->bindTexture(8);
+    warpCS_I->dispatch(groupX_HR_Gather, groupY_HR_Gather, groupZ_HR);
+    endPacingPass("Warp_I");
+    if (warpReferenceCS_I)
+    {
+        warpReferenceCS_I->use();
+        precisionReference->bindImageUnit(7, GL_WRITE_ONLY);
+        warpReferenceCS_I->dispatch(groupX_HR_Gather, groupY_HR_Gather, groupZ_HR);
+        reportPrecision("Warp_I", *frameGenerationResult);
+        endPacingPass(nullptr);
+    }
+}
+
+void OffscreenRenderer::extrapolate()
+{
+    // The passes of an extrapolated frame, only timed: the output is discarded, and the samples are placed with the
+    // interpolation uniforms of the frame, which does not change the work
+    pacingFrameType = PacingFrameType::Extrapolated;
+    clearCS_E->use();
+    extrapolationReprojection->bindImageUnit(0, GL_WRITE_ONLY);
+    clearCS_E->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("Clear");
+
+    reprojectCS_E->use();
+    bindGeometry(0, 1, -1, 2);
+    extrapolationReprojection->bindImageUnit(3, GL_READ_WRITE);
+    reprojectCS_E->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("Reproject_E");
+
+    fillCS_E->use();
+    extrapolationReprojection->bindTexture(0);
+    extrapolationFilledReprojection->bindImageUnit(1, GL_WRITE_ONLY);
+    fillCS_E->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("Fill");
+
+    warpCS_E->use();
+    extrapolationFilledReprojection->bindTexture(0);
+    currentHRColor->bindTexture(1);
+    bindGeometry(2, 3, -1, 4);
+    extrapolationResult->bindImageUnit(5, GL_WRITE_ONLY);
+    sampleLut->bindTexture(6);
+    warpCS_E->dispatch(groupX_HR_Gather, groupY_HR_Gather, groupZ_HR);
+    endPacingPass("Warp_E");
+    if (warpReferenceCS_E)
+    {
+        warpReferenceCS_E->use();
+        precisionReference->bindImageUnit(5, GL_WRITE_ONLY);
+        warpReferenceCS_E->dispatch(groupX_HR_Gather, groupY_HR_Gather, groupZ_HR);
+        reportPrecision("Warp_E", *extrapolationResult);
+        endPacingPass(nullptr);
+    }
+}
+
+void OffscreenRenderer::pushPullFill()
+{
+    // Push: filledReprojection -> level 1 -> ... -> 1x1
+    pushFillCS->use();
+    for (size_t i = 0; i < pushPullLevels.size(); i++)
+    {
+        shared_ptr<Texture> coarse = pushPullLevels[i];
+        (i == 0 ? filledReprojection : pushPullLevels[i - 1])->bindTexture(0);
+        coarse->bindImageUnit(1, GL_WRITE_ONLY);
+        pushFillCS->dispatch((coarse->getWidth() + localSize - 1) / localSize, (coarse->getHeight() + localSize - 1) / localSize, 1);
+    }
+
+    // Pull: 1x1 -> ... -> level 1 -> filledReprojection, only invalid pixels are replaced
+    pullFillCS->use();
+    for (size_t i = pushPullLevels.size(); i > 0; i--)
+    {
+        shared_ptr<Texture> fine = i == 1 ? filledReprojection : pushPullLevels[i - 2];
+        pushPullLevels[i - 1]->bindTexture(0);
+        fine->bindImageUnit(1, GL_READ_WRITE);
+        pullFillCS->dispatch((fine->getWidth() + localSize - 1) / localSize, (fine->getHeight() + localSize - 1) / localSize, 1);
+    }
+}
+
+void OffscreenRenderer::reprojectRaster()
+{
+    // Dilated depth and motion vectors were written as images
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+
+    // The caller's framebuffers, viewport, vertex array and depth test are restored afterwards
+    GLint drawFramebuffer, readFramebuffer, vertexArray, depthFunc;
+    GLint viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+    glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, reprojectionFramebuffer);
+    glViewport(0, 0, renderWidth, renderHeight);
+    const GLuint invalidReprojection[4] = { 0xFFFFFFFFu, 0, 0, 0 };
+    const GLfloat farDepth = 1.0f;
+    glClearBufferuiv(GL_COLOR, 0, invalidReprojection);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+    // Sources at equal depth go to the one drawn last, unlike the minimum relative position of Reproject_I
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL);
+
+    reprojectRasterRS_I->use();
+    bindGeometry(0, 1, -1, 2);
+    glBindVertexArray(reprojectionVertexArray);
+    if (reprojectionEngine == ReprojectionEngine::RasterMesh)
+    {
+#ifndef ENABLE_GLES
+        // Always on in OpenGL ES
+        const GLboolean primitiveRestart = glIsEnabled(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+        glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+#endif
+        glDrawElements(GL_TRIANGLE_STRIP, reprojectionIndexCount, GL_UNSIGNED_INT, nullptr);
+#ifndef ENABLE_GLES
+        if (!primitiveRestart)
+        {
+            glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+        }
+#endif
+    }
+    else
+    {
+        glDrawArrays(GL_POINTS, 0, renderWidth * renderHeight);
+    }
+    glBindVertexArray(vertexArray);
+
+    glDepthFunc(depthFunc);
+    if (!depthTest)
+    {
+        glDisable(GL_DEPTH_TEST);
+    }
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+}
+
+void OffscreenRenderer::benchmarkDispatchOrders()
+{
+    // Warp_I of the last generated frame with its resolved motion scaled, every order on the same input
+    const int repetitions = 20;
+    const float motionScales[] = { 0.0f, 1.0f, 4.0f, 16.0f };
+    const char* orderNames[] = { "RowMajor", "Morton", "Column" };
+    const char* orderDefines[] = { nullptr, "ENABLE_MORTON_DISPATCH", "ENABLE_COLUMN_DISPATCH" };
+    const int orderGroupX[] = { groupX_HR, (groupX_HR + 7) / 8 * 8, groupX_HR };
+    const int orderGroupY[] = { groupY_HR, (groupY_HR + 7) / 8 * 8, groupY_HR };
+
+    shared_ptr<ComputeShader> orderWarpCS[3];
+    for (int order = 0; order < 3; order++)
+    {
+        std::vector<std::string> defines;
+        if (enableGeometryBuffer)
+        {
+            defines.push_back("ENABLE_GEOMETRY_BUFFER");
+        }
+        if (orderDefines[order])
+        {
+            defines.push_back(orderDefines[order]);
+        }
+        orderWarpCS[order] = make_shared<ComputeShader>(resourcesDirectory + "FrameGeneration/Warp_I.comp", defines);
+    }
+
+    std::vector<GLuint> motion(renderWidth * renderHeight * 4);
+    resolvedMotion->getImage(GL_RGBA_INTEGER, GL_UNSIGNED_INT, motion.data());
+    shared_ptr<Texture> scaledMotion = make_shared<Texture>(GL_RG32UI, renderWidth, renderHeight, GL_NEAREST);
+    std::vector<GLuint> scaled(motion.size());
+
+#ifndef ENABLE_GLES
+    GLuint queries[2];
+    glGenQueries(2, queries);
+#endif
+    std::cout << "Dispatch order benchmark (Warp_I, " << presentationWidth << "x" << presentationHeight << ", ms per dispatch)" << std::endl;
+    for (float motionScale : motionScales)
+    {
+        // Both motions are packHalf2x16, y = INVALID marks the linear fallback
+        for (size_t i = 0; i < motion.size(); i += 4)
+        {
+            for (size_t c = 0; c < 2; c++)
+            {
+                const uint16_t x = static_cast<uint16_t>(floatToHalf(halfToFloat(static_cast<uint16_t>(motion[i + c] & 0xFFFFu)) * motionScale));
+                const uint16_t y = static_cast<uint16_t>(floatToHalf(halfToFloat(static_cast<uint16_t>(motion[i + c] >> 16)) * motionScale));
+                scaled[i + c] = (static_cast<GLuint>(y) << 16) | x;
+            }
+            if (motion[i + 1] == 0xFFFFFFFFu)
+            {
+                scaled[i + 1] = 0xFFFFFFFFu;
+            }
+        }
+        scaledMotion->loadFromMemory(scaled.data(), GL_RGBA_INTEGER, GL_UNSIGNED_INT);
+
+        std::cout << "  motion x" << std::setw(2) << motionScale << ":";
+        for (int order = 0; order < 3; order++)
+        {
+            orderWarpCS[order]->use();
+            scaledMotion->bindTexture(0);
+            currentHRColor->bindTexture(1);
+            previousHRColor->bindTexture(2);
+            bindGeometry(3, -1, 4, -1);
+            frameGenerationResult->bindImageUnit(7, GL_WRITE_ONLY);
+            sampleLut->bindTexture(8);
+            // Warm up
+            orderWarpCS[order]->dispatch(orderGroupX[order], orderGroupY[order], 1);
+
+#ifdef ENABLE_GLES
+            // No timer queries in OpenGL ES 3.1
+            glFinish();
+            auto begin = std::chrono::steady_clock::now();
+            for (int i = 0; i < repetitions; i++)
+            {
+                orderWarpCS[order]->dispatch(orderGroupX[order], orderGroupY[order], 1);
+            }
+            glFinish();
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+#else
+            glQueryCounter(queries[0], GL_TIMESTAMP);
+            for (int i = 0; i < repetitions; i++)
+            {
+                orderWarpCS[order]->dispatch(orderGroupX[order], orderGroupY[order], 1);
+            }
+            glQueryCounter(queries[1], GL_TIMESTAMP);
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end);
+            double milliseconds = static_cast<double>(end - begin) * 1e-6;
+#endif
+            std::cout << " " << orderNames[order] << " " << std::fixed << std::setprecision(3) << milliseconds / repetitions;
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+#ifndef ENABLE_GLES
+    glDeleteQueries(2, queries);
+#endif
+}
+
+void OffscreenRenderer::beginFrameStats()
+{
+    FrameStatsSlot& slot = frameStatsSlots[frameStatsSlotIndex];
+    if (slot.fence)
+    {
+        // Every slot is in flight
+        readFrameStats(slot, true);
+    }
+    const GLuint zeros[frameStatCount] = {};
+    slot.counters->setData(0, sizeof(zeros), zeros);
+    slot.counters->bindBase(17);
+}
+
+void OffscreenRenderer::endFrameStats()
+{
+    if (!isFinalOutput())
+    {
+        return;
+    }
+    FrameStatsSlot& slot = frameStatsSlots[frameStatsSlotIndex];
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.outputFrame = currentOutputFrame;
+    frameStatsSlotIndex = (frameStatsSlotIndex + 1) % static_cast<int>(frameStatsSlots.size());
+
+    // Report the finished frames in order without waiting
+    for (int i = 0; i < static_cast<int>(frameStatsSlots.size()); i++)
+    {
+        FrameStatsSlot& pending = frameStatsSlots[(frameStatsSlotIndex + i) % frameStatsSlots.size()];
+        if (!pending.fence)
+        {
+            continue;
+        }
+        const GLenum status = glClientWaitSync(pending.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        readFrameStats(pending, false);
+    }
+}
+
+void OffscreenRenderer::readFrameStats(FrameStatsSlot& slot, bool wait)
+{
+    if (wait)
     {
-        currentHRColor              = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
-        previousDilatedDepth        = make_shared<Texture>(GL_R32F, renderWidth, renderHeight, GL_NEAREST);
-        previousDilatedMotionVector = nullptr;
-        previousHRColor             = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+        GLenum status;
+        do
+        {
+            status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
     }
-    
-    reprojection                = make_shared<Texture>(GL_R32UI, renderWidth, renderHeight, GL_NEAREST);
-    filledReprojection          = make_shared<Texture>(GL_R32UI, renderWidth, renderHeight, GL_NEAREST);
-    frameGenerationResult       = make_shared<Texture>(GL_RGBA8, presentationWidth, presentationHeight, GL_LINEAR);
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
 
-    outputColor                 = nullptr;
+    GLuint counters[frameStatCount];
+    slot.counters->getData(0, sizeof(counters), counters);
+    std::cout << "Frame " << slot.outputFrame << ":";
+    frameStatsFile << slot.outputFrame;
+    for (int i = 0; i < frameStatCount; i++)
+    {
+        std::cout << " " << frameStatNames[i] << " " << counters[i];
+        frameStatsFile << "," << counters[i];
+    }
+    std::cout << std::endl;
+    frameStatsFile << std::endl;
+}
 
-    // LUTs
-    sampleLut->loadLUT(resourcesDirectory + "lut.exr");
+std::vector<std::string> OffscreenRenderer::parseResourceNames(const std::string& list, const char* use) const
+{
+    std::vector<std::string> names;
+    for (const std::string& name : splitValues(list))
+    {
+        shared_ptr<Texture> texture = getDumpResource(name);
+        uint32_t channels;
+        DumpComponentType componentType;
+        if (!texture || !getDumpFormat(texture->getFormat(), channels, componentType))
+        {
+            std::cout << "ERROR: Cannot " << use << " " << name << ", unknown or not used in this configuration" << std::endl;
+            continue;
+        }
+        names.push_back(name);
+    }
+    return names;
 }
 
-void OffscreenRenderer::execute()
+shared_ptr<Texture> OffscreenRenderer::getDumpResource(const std::string& name) const
 {
-    if (!enableInterpolation)
+    // Current dilated depth and motion vectors (the geometry buffer with enableGeometryBuffer), the HR color of the
+    // frame and the history it blended
+    const std::pair<const char*, shared_ptr<Texture>> resources[] =
     {
-        generatedFramesCount = 0;
+        { "inputDepth", inputDepth },
+        { "inputMotionVector", inputMotionVector },
+        { "dilatedDepth", currentDilatedDepth },
+        { "dilatedMotionVector", currentDilatedMotionVector },
+        { "reprojection", reprojection },
+        { "filledReprojection", filledReprojection },
+        { "resolvedMotion", resolvedMotion },
+        { "frameGenerationResult", frameGenerationResult },
+        { "hrColor", currentHRColor },
+        { "history", previousHRColor }
+    };
+    for (const auto& resource : resources)
+    {
+        if (name == resource.first)
+        {
+            return resource.second;
+        }
     }
-    currentOutputFrame = 0;
-    isFirstCycleCompleted = false;
-    jitterOffsetIndex = 0;
-    for (currentInputFrame = startInputFrame; currentInputFrame < endInputFrame; currentInputFrame++)
+    return nullptr;
+}
+
+void OffscreenRenderer::dumpFrame()
+{
+    if (isFinalOutput() && currentOutputFrame >= dumpStartFrame && currentOutputFrame < dumpEndFrame)
     {
-        for (int cycleFrameIndex = 0; cycleFrameIndex < generatedFramesCount + 1; cycleFrameIndex++, currentOutputFrame++)
+        for (const std::string& name : dumpResourceNames)
         {
-            if (cycleFrameIndex == 0)
-            {
-                // Rendered frame
-                isRenderedFrame = true;
-                isGeneratedFrame = false;
+            shared_ptr<Texture> texture = getDumpResource(name);
+            DumpReadback readback;
+            memset(&readback.header, 0, sizeof(readback.header));
+            memcpy(readback.header.magic, dumpMagic, sizeof(dumpMagic));
+            readback.header.version = dumpVersion;
+            readback.header.width = static_cast<uint32_t>(texture->getWidth());
+            readback.header.height = static_cast<uint32_t>(texture->getHeight());
+            DumpComponentType componentType = DumpComponentType::UInt8;
+            getDumpFormat(texture->getFormat(), readback.header.channels, componentType);
+            readback.header.componentType = static_cast<uint32_t>(componentType);
+            readback.header.glFormat = texture->getFormat();
+            readback.header.frame = currentOutputFrame;
+            strncpy(readback.header.name, name.c_str(), sizeof(readback.header.name) - 1);
 
-                // Load rendered frame
-                load();
+            // RGBA reads are valid for every color format in OpenGL ES as well
+            const GLenum format = componentType == DumpComponentType::UInt32 ? GL_RGBA_INTEGER : GL_RGBA;
+            const GLenum type = componentType == DumpComponentType::UInt32 ? GL_UNSIGNED_INT :
+                componentType == DumpComponentType::Float32 ? GL_FLOAT : GL_UNSIGNED_BYTE;
+            const GLsizeiptr componentSize = componentType == DumpComponentType::UInt8 ? 1 : 4;
+            glGenBuffers(1, &readback.pixelBuffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pixelBuffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, texture->getWidth() * texture->getHeight() * 4 * componentSize, nullptr, GL_STREAM_READ);
+            texture->getImage(format, type, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            dumpReadbacks.push_back(readback);
+        }
+    }
+    writeDumps(false);
+}
 
-                jitterOffset = jitterSequence[jitterOffsetIndex];
-                jitterOffsetIndex = (jitterOffsetIndex + 1) % jitterSequenceLength;
-            }
-            else
-            {
-                // Generated frame
-                isRenderedFrame = false;
-                isGeneratedFrame = true;
-            }
-            
-            delta = static_cast<float>(cycleFrameIndex) / static_cast<float>(generatedFramesCount + 1);
-            
-            render();
-            save();
+void OffscreenRenderer::writeDumps(bool wait)
+{
+    while (!dumpReadbacks.empty())
+    {
+        DumpReadback& readback = dumpReadbacks.front();
+        GLenum status;
+        do
+        {
+            status = glClientWaitSync(readback.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000 : 0);
+        } while (wait && status == GL_TIMEOUT_EXPIRED);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            return;
         }
+        glDeleteSync(readback.fence);
 
-        if (!isFirstCycleCompleted)
+        const DumpHeader& header = readback.header;
+        const size_t componentSize = static_cast<DumpComponentType>(header.componentType) == DumpComponentType::UInt8 ? 1 : 4;
+        const size_t texelCount = static_cast<size_t>(header.width) * header.height;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pixelBuffer);
+        const GLubyte* rgba = static_cast<const GLubyte*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, texelCount * 4 * componentSize, GL_MAP_READ_BIT));
+        if (rgba)
         {
-            if (enableInterpolation)
+            std::vector<GLubyte> texels(texelCount * header.channels * componentSize);
+            for (size_t i = 0; i < texelCount; i++)
+            {
+                memcpy(&texels[i * header.channels * componentSize], rgba + i * 4 * componentSize, header.channels * componentSize);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+            std::stringstream ss;
+            ss << outputDirectory << std::setw(4) << std::setfill('0') << header.frame << "_" << header.name << ".dump";
+            std::ofstream file(ss.str(), std::ios::binary);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(texels.data()), texels.size());
+            if (!file)
             {
-                outputColor = nullptr;
-                currentOutputFrame = 0;
+                std::cout << "ERROR: Failed to write " << ss.str() << std::endl;
             }
-            isFirstCycleCompleted = true;
         }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(1, &readback.pixelBuffer);
+        dumpReadbacks.pop_front();
     }
 }
 
-void OffscreenRenderer::load()
+void OffscreenRenderer::beginPacingTiming()
 {
-    // Load textures
-    std::stringstream ss;
-    ss << std::setw(4) << std::setfill('0') << currentInputFrame << ".png";
-    std::string fileName = ss.str();
+    PacingTiming timing;
+    timing.isRenderedFrame = isRenderedFrame;
+    timing.beginQuery = 0;
+    timing.beginMilliseconds = 0.0;
+#ifdef ENABLE_GLES
+    // No timer queries in OpenGL ES 3.1, the passes are timed on the host between glFinish calls
+    glFinish();
+    timing.beginMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    glGenQueries(1, &timing.beginQuery);
+    glQueryCounter(timing.beginQuery, GL_TIMESTAMP);
+#endif
+    pacingTimings.push_back(timing);
+    isTimingPasses = true;
+    pacingFrameType = isRenderedFrame ? PacingFrameType::Rendered : PacingFrameType::Interpolated;
+}
 
-    GLenum sourceFormat = GL_RGB;
-    GLenum sourceType = GL_UNSIGNED_BYTE;
-    if(!enableSuperResolution)
-    {
-        inputColor->loadFromFile(inputHrColorDirectory + fileName, sourceFormat, sourceType);
-    }
-    else
+void OffscreenRenderer::endPacingTiming()
+{
+    isTimingPasses = false;
+}
+
+void OffscreenRenderer::endPacingPass(const char* name)
+{
+    if (!isTimingPasses)
     {
-        rawInputHRColor->loadFromFile(inputHrColorDirectory + fileName, sourceFormat, sourceType);
+        return;
     }
-    
-    sourceFormat = GL_RGBA;
-    std::string depthDirectory = enableSuperResolution ? inputLrDepthDirectory : inputHrDepthDirectory;
-    std::string motionVectorXDirectory = enableSuperResolution ? inputLrMotionVectorXDirectory : inputHrMotionVectorXDirectory;
-    std::string motionVectorYDirectory = enableSuperResolution ? inputLrMotionVectorYDirectory : inputHrMotionVectorYDirectory;
-    rawInputDepth->loadFromFile(depthDirectory + fileName, sourceFormat, sourceType);
-    rawInputMotionVectorX->loadFromFile(motionVectorXDirectory + fileName, sourceFormat, sourceType);
-    rawInputMotionVectorY->loadFromFile(motionVectorYDirectory + fileName, sourceFormat, sourceType);
+    PacingPass pass;
+    pass.name = name;
+    pass.frameType = pacingFrameType;
+    pass.query = 0;
+    pass.milliseconds = 0.0;
+#ifdef ENABLE_GLES
+    glFinish();
+    pass.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    glGenQueries(1, &pass.query);
+    glQueryCounter(pass.query, GL_TIMESTAMP);
+#endif
+    pacingTimings.back().passes.push_back(pass);
 }
 
-void OffscreenRenderer::render()
+void OffscreenRenderer::getPassCosts(std::vector<PacingPassCost>& costs)
 {
-    bindUniformBuffer();
-
-    if (isRenderedFrame)
+    costs.clear();
+    int renderedFrameCount = 0;
+    int generatedFrameCount = 0;
+    for (PacingTiming& timing : pacingTimings)
     {
-        swapBuffers();
-        processInputs();
-        preprocess();
-
-        if (enableSuperResolution)
+        (timing.isRenderedFrame ? renderedFrameCount : generatedFrameCount)++;
+#ifdef ENABLE_GLES
+        double previous = timing.beginMilliseconds;
+#else
+        GLuint64 previous = 0;
+        glGetQueryObjectui64v(timing.beginQuery, GL_QUERY_RESULT, &previous);
+        glDeleteQueries(1, &timing.beginQuery);
+#endif
+        for (PacingPass& pass : timing.passes)
         {
-            if (!isFirstCycleCompleted)
+#ifdef ENABLE_GLES
+            const double end = pass.milliseconds;
+            pass.milliseconds = end - previous;
+#else
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &end);
+            glDeleteQueries(1, &pass.query);
+            pass.milliseconds = static_cast<double>(end - previous) * 1e-6;
+#endif
+            previous = end;
+            if (!pass.name)
             {
-                // First frame
-                upsampleFirstFrame();
-                outputColor = currentHRColor;
+                continue;
             }
-            else
+            size_t index = 0;
+            while (index < costs.size() && (costs[index].frameType != pass.frameType || costs[index].name != pass.name))
             {
-                superSample();
-                outputColor = currentHRColor;
+                index++;
             }
-        }
-        if (enableInterpolation && isFirstCycleCompleted)
-        {
-            outputColor = previousHRColor;
+            if (index == costs.size())
+            {
+                PacingPassCost cost = { pass.name, pass.frameType, 0.0 };
+                costs.push_back(cost);
+            }
+            costs[index].milliseconds += pass.milliseconds;
         }
     }
-    else if (isGeneratedFrame)
+    pacingTimings.clear();
+    for (PacingPassCost& cost : costs)
     {
-        if (enableInterpolation && isFirstCycleCompleted)
+        cost.milliseconds /= cost.frameType == PacingFrameType::Rendered ? renderedFrameCount : generatedFrameCount;
+    }
+}
+
+void OffscreenRenderer::getFrameCosts(double& renderedFrameCost, double& generatedFrameCost)
+{
+    std::vector<PacingPassCost> costs;
+    getPassCosts(costs);
+    renderedFrameCost = 0.0;
+    generatedFrameCost = 0.0;
+    for (const PacingPassCost& cost : costs)
+    {
+        if (cost.frameType == PacingFrameType::Rendered)
         {
-            interpolate();
-            outputColor = frameGenerationResult;
+            renderedFrameCost += cost.milliseconds;
+        }
+        else if (cost.frameType == PacingFrameType::Interpolated)
+        {
+            generatedFrameCost += cost.milliseconds;
         }
     }
 }
 
-void OffscreenRenderer::save()
+void OffscreenRenderer::reportPacing()
 {
-    if (!outputColor)
+    // Mean GPU cost of the passes of a rendered frame and of one interpolated or extrapolated frame
+    std::vector<PacingPassCost> costs;
+    getPassCosts(costs);
+    double frameCosts[3] = { 0.0, 0.0, 0.0 };
+    for (const PacingPassCost& cost : costs)
     {
+        frameCosts[static_cast<int>(cost.frameType)] += cost.milliseconds;
+    }
+    const double renderedFrameCost = frameCosts[static_cast<int>(PacingFrameType::Rendered)];
+    const double interpolatedFrameCost = frameCosts[static_cast<int>(PacingFrameType::Interpolated)];
+    const double extrapolatedFrameCost = frameCosts[static_cast<int>(PacingFrameType::Extrapolated)];
+    if (renderedFrameCost == 0.0)
+    {
+        std::cout << "ERROR: Pacing simulation needs at least two input frames" << std::endl;
         return;
     }
 
-    std::stringstream ss;
-    ss << std::setw(4) << std::setfill('0') << currentOutputFrame << ".png";
-    std::string fileName = ss.str();
-
-    outputColor->saveAsPNG((outputDirectory + fileName).c_str(), 4);
-}
-
-void OffscreenRenderer::bindUniformBuffer()
-{
-    /*
-    layout (binding = 10, std140) uniform cb_t
+    std::vector<double> frameTimes(endInputFrame - startInputFrame, renderFrameTime);
+    if (!renderFrameTimeTracePath.empty() && !PacingSimulator::loadFrameTimeTrace(renderFrameTimeTracePath, endInputFrame - startInputFrame, frameTimes))
     {
-                                        offset  size
-        vec4 render_size;               0       16
-        vec4 presentation_size;         16      16
-        vec4 delta;                     32      16  
-        vec2 jitter_offset;             48      8
-        float depth_diff_threshold_sr;  56      4  
-        float color_diff_threshold_fg;  60      4
-        float depth_diff_threshold_fg;  64      4
-        float depth_scale;              68      4
-        float depth_bias;               72      4
-        float render_scale;             76      4
-    };
-    // size = 80
-    */
+        return;
+    }
+    PacingSimulator simulator(frameTimes, renderedFrameCost, interpolatedFrameCost, extrapolatedFrameCost);
+    const PacingSimulator::Mode modes[2] = { PacingSimulator::Mode::Interpolation, PacingSimulator::Mode::Extrapolation };
+    const char* modeNames[2] = { "interpolation", "extrapolation" };
 
-    UniformBlock uniformBlock;
-    uniformBlock.render_size.x = static_cast<float>(renderWidth);
-    uniformBlock.render_size.y = static_cast<float>(renderHeight);
-    uniformBlock.render_size.z = 1.0f / static_cast<float>(renderWidth);
-    uniformBlock.render_size.w = 1.0f / static_cast<float>(renderHeight);
-    uniformBlock.presentation_size.x = static_cast<float>(presentationWidth);
-    uniformBlock.presentation_size.y = static_cast<float>(presentationHeight);
-    uniformBlock.presentation_size.z = 1.0f / static_cast<float>(presentationWidth);
-    uniformBlock.presentation_size.w = 1.0f / static_cast<float>(presentationHeight);
-    uniformBlock.delta.x = delta;
-    uniformBlock.delta.y = delta * 0.5f;
-    uniformBlock.delta.z = delta * 1.5f;
-    uniformBlock.delta.w = delta * delta * 0.5f;
-    uniformBlock.jitter_offset.x = jitterOffset.x;
-    uniformBlock.jitter_offset.y = jitterOffset.y;
-    uniformBlock.depth_diff_threshold_sr = depthDiffThresholdSR;
-    uniformBlock.color_diff_threshold_fg = colorDiffThresholdFG;
-    uniformBlock.depth_diff_threshold_fg = depthDiffThresholdFG;
-    uniformBlock.depth_scale = depthScale;
-    uniformBlock.depth_bias = depthBias;
-    uniformBlock.render_scale = upsampleScale;
-    
-    constexpr int uniformBlockBindingPoint = 10;
-    constexpr int uniformBlockSize = sizeof(UniformBlock);
-    
-    glGenBuffers(1, &uniformBuffer);
-    glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
-    glBufferData(GL_UNIFORM_BUFFER, uniformBlockSize, nullptr, GL_STATIC_DRAW);
-    glBindBufferRange(GL_UNIFORM_BUFFER, uniformBlockBindingPoint, uniformBuffer, 0, uniformBlockSize);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, uniformBlockSize, &uniformBlock);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-}
+    const char* frameTypeNames[3] = { "rendered", "interpolated", "extrapolated" };
+    std::cout << "Pacing: " << frameTimes.size() << " rendered frames, GPU " << std::fixed << std::setprecision(3) << renderedFrameCost
+        << " ms per rendered frame, " << interpolatedFrameCost << " ms per interpolated frame, " << extrapolatedFrameCost
+        << " ms per extrapolated frame" << std::endl;
+    for (const PacingPassCost& cost : costs)
+    {
+        std::cout << "  " << frameTypeNames[static_cast<int>(cost.frameType)] << " " << cost.name << ": " << cost.milliseconds << " ms" << std::endl;
+    }
+    const int maxGeneratedFramesCount = interpolatedFrameCost > 0.0 ? std::max(4, generatedFramesCount) : 0;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        for (int n = 0; n <= maxGeneratedFramesCount; n++)
+        {
+            PacingSimulator::Summary summary = PacingSimulator::summarize(simulator.simulate(modes[mode], n));
+            std::cout << "  " << modeNames[mode] << " x" << n + 1 << ": " << std::setprecision(1) << summary.outputRate << " fps, latency "
+                << std::setprecision(2) << summary.meanLatency << " ms (max " << summary.maxLatency << "), interval "
+                << summary.meanInterval << " ms (jitter " << summary.intervalJitter << ", max " << summary.maxInterval << ")" << std::endl;
+        }
+    }
+    std::cout << std::defaultfloat;
 
-void OffscreenRenderer::swapBuffers()
-{
-    if (enableInterpolation)
+    std::ofstream file(outputDirectory + "pacing.csv");
+    if (!file)
     {
-        std::swap(currentHRColor, previousHRColor);
-        std::swap(currentDilatedDepth, previousDilatedDepth);
-        std::swap(currentDilatedMotionVector, previousDilatedMotionVector);
+        std::cout << "ERROR: Failed to open " << outputDirectory << "pacing.csv" << std::endl;
+        return;
     }
-    else 
+    file << "mode,generated_frames,output_frame,source_frame,generated_index,ready_ms,present_ms,latency_ms" << std::endl;
+    const int csvGeneratedFramesCount = interpolatedFrameCost > 0.0 ? generatedFramesCount : 0;
+    for (int mode = 0; mode < 2; mode++)
     {
-        if (enableSuperResolution)
+        std::vector<PacingSimulator::OutputFrame> frames = simulator.simulate(modes[mode], csvGeneratedFramesCount);
+        for (size_t i = 0; i < frames.size(); i++)
         {
-            std::swap(currentHRColor, previousHRColor);
-            std::swap(currentDilatedDepth, previousDilatedDepth);
+            const PacingSimulator::OutputFrame& frame = frames[i];
+            file << modeNames[mode] << "," << csvGeneratedFramesCount << "," << i << "," << frame.sourceFrame << "," << frame.generatedIndex << ","
+                << frame.readyTime << "," << frame.presentTime << "," << frame.latency << std::endl;
         }
     }
 }
 
-void OffscreenRenderer::processInputs()
+void OffscreenRenderer::hashFrame()
 {
-    // Decode depths
-    loadDepthCS->use();
-    rawInputDepth->bindTexture(0);
-    inputDepth->bindImageUnit(1, GL_WRITE_ONLY);
-    loadDepthCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
-
-    // Decode motion vectors
-    loadMotionVectorCS->use();
-    rawInputMotionVectorX->bindTexture(0);
-    rawInputMotionVectorY->bindTexture(1);
-    inputMotionVector->bindImageUnit(2, GL_WRITE_ONLY);
-    loadMotionVectorCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    if (!isFinalOutput())
+    {
+        return;
+    }
+    HashSlot& slot = hashSlots[hashSlotIndex];
+    if (slot.fence)
+    {
+        // Every slot is in flight
+        readHashes(slot, true);
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    for (size_t i = 0; i < slot.hashes.size(); i++)
+    {
+        shared_ptr<Texture> texture = i < hashResourceNames.size() ? getDumpResource(hashResourceNames[i]) : outputColor;
+        uint32_t channels;
+        DumpComponentType componentType = DumpComponentType::UInt8;
+        getDumpFormat(texture->getFormat(), channels, componentType);
+        const bool isUint = componentType == DumpComponentType::UInt32;
+        const ComputeShader& hashCS = isUint ? *hashUintTextureCS : *hashTextureCS;
+        const GLuint zeros[hashBufferSize] = {};
+        slot.hashes[i]->setData(0, sizeof(zeros), zeros);
+        slot.hashes[i]->bindBase(18);
+        hashCS.use();
+        texture->bindTexture(0);
+        hashCS.dispatch((texture->getWidth() + localSize - 1) / localSize, (texture->getHeight() + localSize - 1) / localSize, 1);
+        if (resolveProjectionHashCS && !isUint)
+        {
+            resolveProjectionHashCS->use();
+            resolveProjectionHashCS->dispatch(1, 1, 1);
+        }
+    }
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.outputFrame = currentOutputFrame;
+    hashSlotIndex = (hashSlotIndex + 1) % static_cast<int>(hashSlots.size());
 
-    // Sample HR color with jittered position to generate LR color
-    if (enableSuperResolution)
+    // Compare the finished frames in order without waiting
+    for (int i = 0; i < static_cast<int>(hashSlots.size()); i++)
     {
-        loadLRColorCS->use();
-        rawInputHRColor->bindTexture(0);
-        inputColor->bindImageUnit(1, GL_WRITE_ONLY);
-        loadLRColorCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+        HashSlot& pending = hashSlots[(hashSlotIndex + i) % hashSlots.size()];
+        if (!pending.fence)
+        {
+            continue;
+        }
+        const GLenum status = glClientWaitSync(pending.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        readHashes(pending, false);
     }
 }
 
-void OffscreenRenderer::preprocess()
+void OffscreenRenderer::readHashes(HashSlot& slot, bool wait)
 {
-    // Dilate
-    dilateCS->use();
-    inputDepth->bindTexture(0);
-    inputMotionVector->bindTexture(1);
-    currentDilatedDepth->bindImageUnit(2, GL_WRITE_ONLY);
-    currentDilatedMotionVector->bindImageUnit(3, GL_WRITE_ONLY);
-    dilateCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    if (wait)
+    {
+        GLenum status;
+        do
+        {
+            status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
 
-    // Copy inputColor -> currentHRColor
-    if (enableInterpolation && !enableSuperResolution)
+    // The hash trail of a frame follows the pipeline, the first differing texture is where it diverged
+    std::string divergence;
+    for (size_t i = 0; i < slot.hashes.size(); i++)
+    {
+        GLuint words[2];
+        slot.hashes[i]->getData(0, sizeof(words), words);
+        const unsigned long long hash = (static_cast<unsigned long long>(words[0]) << 32) | words[1];
+        const std::string name = i < hashResourceNames.size() ? hashResourceNames[i] : "output";
+        hashFile << slot.outputFrame << " " << name << " " << std::hex << std::setw(16) << std::setfill('0') << hash
+            << std::dec << std::setfill(' ') << std::endl;
+        if (goldenHashPath.empty() || !divergence.empty())
+        {
+            continue;
+        }
+        auto golden = goldenHashes.find(std::make_pair(slot.outputFrame, name));
+        if (golden == goldenHashes.end())
+        {
+            divergence = name + " (not in the golden hashes)";
+        }
+        else if (golden->second != hash)
+        {
+            // Projections of float textures pass within an RMS difference per channel: each 16-bit projection difference
+            // is a sample of N(0, sum of the squared differences) in 1/256 fixed point (the unused channels are constant)
+            shared_ptr<Texture> texture = i < hashResourceNames.size() ? getDumpResource(name) : outputColor;
+            uint32_t channels = 4;
+            DumpComponentType componentType = DumpComponentType::UInt8;
+            getDumpFormat(texture->getFormat(), channels, componentType);
+            double difference = std::numeric_limits<double>::infinity();
+            if (hashMode == HashMode::Tolerance && componentType != DumpComponentType::UInt32)
+            {
+                double squaredSum = 0.0;
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    const int16_t laneDifference = static_cast<int16_t>(static_cast<uint16_t>((hash >> (lane * 16)) - (golden->second >> (lane * 16))));
+                    squaredSum += static_cast<double>(laneDifference) * laneDifference;
+                }
+                difference = std::sqrt(squaredSum / 4.0 / (static_cast<double>(channels) * texture->getWidth() * texture->getHeight())) / 256.0;
+                maxHashDifference = std::max(maxHashDifference, difference);
+            }
+            if (difference > hashTolerance)
+            {
+                std::stringstream ss;
+                ss << name;
+                if (hashMode == HashMode::Tolerance && componentType != DumpComponentType::UInt32)
+                {
+                    ss << " (RMS difference ~" << difference << ")";
+                }
+                divergence = ss.str();
+            }
+        }
+    }
+    hashedFrameCount++;
+    if (!divergence.empty())
     {
-        glCopyImageSubData(
-            inputColor->getID(), GL_TEXTURE_2D, 0, 0, 0, 0,
-            currentHRColor->getID(), GL_TEXTURE_2D, 0, 0, 0, 0,
-            renderWidth, renderHeight, 1);
+        std::cout << "Frame " << slot.outputFrame << ": hash differs from the golden hash, first in " << divergence << std::endl;
+        if (divergedFrameCount == 0)
+        {
+            std::stringstream ss;
+            ss << "frame " << slot.outputFrame << " in " << divergence;
+            firstDivergence = ss.str();
+        }
+        divergedFrameCount++;
     }
 }
 
-void OffscreenRenderer::interpolate()
+void OffscreenRenderer::interpolateTiled()
 {
-    clearCS->use();
-    reprojection->bindImageUnit(0, GL_WRITE_ONLY);
-    clearCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    // Reset tile counts. HR workgroups per tile = scale^2
+    const GLuint hrGroupsPerTile = static_cast<GLuint>(upsampleScale * upsampleScale);
+    const GLuint dispatchArgs[9] =
+    {
+        0, 1, 1,                    // Dynamic tiles, LR
+        0, hrGroupsPerTile, 1,      // Dynamic tiles, HR
+        0, hrGroupsPerTile, 1,      // Static tiles, HR
+    };
+    tileList->setData(0, sizeof(dispatchArgs), dispatchArgs);
+    tileList->bindBase(11);
+    tileList->bindIndirect();
     
-    reprojectCS_I->use();
-    currentDilatedDepth->bindTexture(0);
-    currentDilatedMotionVector->bindTexture(1);
-    previousDilatedMotionVector->bindTexture(2);
-    reprojection->bindImageUnit(3, GL_READ_WRITE);
-    reprojectCS_I->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    // Classify tiles (also clears reprojection)
+    classifyTilesCS->use();
+    bindGeometry(0, 2, 1, 3);
+    reprojection->bindImageUnit(4, GL_WRITE_ONLY);
+    tileFlags->bindImageUnit(5, GL_READ_WRITE);
+    classifyTilesCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    endPacingPass("ClassifyTiles");
     
-    fillCS->use();
-    reprojection->bindTexture(0);
-    filledReprojection->bindImageUnit(1, GL_WRITE_ONLY);
-    fillCS->dispatch(groupX_LR, groupY_LR, groupZ_LR);
+    compactTilesCS->use();
+    tileFlags->bindImageUnit(0, GL_READ_WRITE);
+    compactTilesCS->dispatch((tileCountX + localSize - 1) / localSize, (tileCountY + localSize - 1) / localSize, 1);
+    endPacingPass("CompactTiles");
     
-    warpCS_I->use();
+    // Dynamic tiles
+    if (reprojectionEngine == ReprojectionEngine::Gather)
+    {
+        reprojectGatherCS_I->use();
+        bindGeometry(0, 1, -1, 2);
+        filledReprojection->bindImageUnit(3, GL_WRITE_ONLY);
+        reprojectGatherCS_I->dispatchIndirect(0);
+        endPacingPass("ReprojectGather_I");
+    }
+    else
+    {
+        if (reprojectRasterRS_I)
+        {
+            // Draws the whole grid, only dynamic tiles are filled and warped
+            reprojectRaster();
+            endPacingPass("ReprojectRaster_I");
+        }
+        else
+        {
+            reprojectCS_I->use();
+            bindGeometry(0, 1, -1, 2);
+            reprojection->bindImageUnit(3, GL_READ_WRITE);
+            reprojectCS_I->dispatchIndirect(0);
+            endPacingPass("Reproject_I");
+        }
+        
+        fillCS->use();
+        reprojection->bindTexture(0);
+        filledReprojection->bindImageUnit(1, GL_WRITE_ONLY);
+        fillCS->dispatchIndirect(0);
+        endPacingPass("Fill");
+    }
+    
+    resolveMotionCS_I->use();
     filledReprojection->bindTexture(0);
+    bindGeometry(-1, 1, -1, 2);
+    resolvedMotion->bindImageUnit(3, GL_WRITE_ONLY);
+    resolveMotionCS_I->dispatchIndirect(0);
+    endPacingPass("ResolveMotion_I");
+    
+    warpCS_I->use();
+    resolvedMotion->bindTexture(0);
     currentHRColor->bindTexture(1);
     previousHRColor->bindTexture(2);
-    currentDilatedDepth->bindTexture(3);
-    previousDilatedDepth->bindTexture(4);
-    currentDilatedMotionVector->bindTexture(5);
-    previousDilatedMotionVector->bindTexture(6);
+    bindGeometry(3, -1, 4, -1);
     frameGenerationResult->bindImageUnit(7, GL_WRITE_ONLY);
     sampleLut->bindTexture(8);
-    warpCS_I->dispatch(groupX_HR, groupY_HR, groupZ_HR);
+    warpCS_I->dispatchIndirect(3 * sizeof(GLuint));
+    endPacingPass("Warp_I");
+    if (warpReferenceCS_I)
+    {
+        warpReferenceCS_I->use();
+        precisionReference->bindImageUnit(7, GL_WRITE_ONLY);
+        warpReferenceCS_I->dispatchIndirect(3 * sizeof(GLuint));
+        endPacingPass(nullptr);
+    }
+    
+    // Static tiles
+    copyCS_I->use();
+    currentHRColor->bindTexture(0);
+    previousHRColor->bindTexture(1);
+    frameGenerationResult->bindImageUnit(2, GL_WRITE_ONLY);
+    sampleLut->bindTexture(3);
+    copyCS_I->dispatchIndirect(6 * sizeof(GLuint));
+    endPacingPass("Copy_I");
+    if (copyReferenceCS_I)
+    {
+        // The reference of the dynamic tiles was written after Warp_I, the frames are compared whole
+        copyReferenceCS_I->use();
+        precisionReference->bindImageUnit(2, GL_WRITE_ONLY);
+        copyReferenceCS_I->dispatchIndirect(6 * sizeof(GLuint));
+        reportPrecision("Warp_I", *frameGenerationResult);
+        endPacingPass(nullptr);
+    }
 }
 
 void OffscreenRenderer::upsampleFirstFrame()
@@ -370,17 +2889,32 @@ void OffscreenRenderer::upsampleFirstFrame()
     inputColor->bindTexture(0);
     currentHRColor->bindImageUnit(1, GL_WRITE_ONLY);
     upsampleFirstFrameCS->dispatch(groupX_HR, groupY_HR, groupZ_HR);
+    if (upsampleFirstFrameReferenceCS)
+    {
+        upsampleFirstFrameReferenceCS->use();
+        precisionReference->bindImageUnit(1, GL_WRITE_ONLY);
+        upsampleFirstFrameReferenceCS->dispatch(groupX_HR, groupY_HR, groupZ_HR);
+        reportPrecision("UpsampleFirstFrame", *currentHRColor);
+    }
 }
 
 void OffscreenRenderer::superSample()
 {
     blendHistoryCS->use();
     inputColor->bindTexture(0);
-    currentDilatedDepth->bindTexture(1);
-    currentDilatedMotionVector->bindTexture(2);
-    previousDilatedDepth->bindTexture(3);
+    bindGeometry(1, 2, 3, -1);
     previousHRColor->bindTexture(4);
     currentHRColor->bindImageUnit(5, GL_WRITE_ONLY);
     sampleLut->bindTexture(6);
-    blendHistoryCS->dispatch(groupX_HR, groupY_HR, groupZ_HR);
+    blendHistoryCS->dispatch(groupX_HR_Gather, groupY_HR_Gather, groupZ_HR);
+    endPacingPass("BlendHistory");
+    if (blendHistoryReferenceCS)
+    {
+        // Same history, so the error does not accumulate over frames
+        blendHistoryReferenceCS->use();
+        precisionReference->bindImageUnit(5, GL_WRITE_ONLY);
+        blendHistoryReferenceCS->dispatch(groupX_HR_Gather, groupY_HR_Gather, groupZ_HR);
+        reportPrecision("BlendHistory", *currentHRColor);
+        endPacingPass(nullptr);
+    }
 }
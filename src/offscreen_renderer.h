@@ -1,9 +1,22 @@
 ﻿#pragma once
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "compute_shader.h"
+#include "cpu_backend.h"
+#include "dump_file.h"
+#include "input_cache.h"
+#include "options.h"
+#include "pacing_simulator.h"
+#include "raster_shader.h"
+#include "storage_buffer.h"
 #include "texture.h"
+#include "uniform_block.h"
 
 using std::shared_ptr;
 using std::make_shared;
@@ -11,13 +24,113 @@ using std::make_shared;
 class OffscreenRenderer
 {
 public:
-    OffscreenRenderer();
+    // Sets the configuration members named by options (e.g. { "generatedFramesCount", "3" }, enums by value name) before
+    // resolving the settings that depend on them. With externalInputs, frames are submitted as textures through
+    // beginFrames()/submitFrame()/receiveFrame()/endFrames() instead of read from the input directories by execute()
+    explicit OffscreenRenderer(const Options& options = Options(), bool externalInputs = false);
+    ~OffscreenRenderer();
     
+    // False if an option has an unknown name or an invalid value
+    bool isConfigured() const { return configured; }
+    // isConfigured() of a renderer of options, creates no backend and needs no OpenGL context
+    static bool validateOptions(const Options& options);
+
+    // False if only the CPU backend runs, then execute() needs no OpenGL context
+    bool requiresOpenGL() const { return backend != Backend::CPU; }
+
     void execute();
 
+    // Parameter sweep (OpenGL backend): inputs are copied from a cache shared by the renderers of the sweep instead of
+    // decoded, every final output goes to outputCallback(output frame, color) instead of a PNG and frames are timed
+    void setSweepTarget(shared_ptr<InputCache> cache, std::function<void(int, const Texture&)> callback);
+    // Mean GPU time in ms of the passes of a rendered and of an interpolated frame after the first cycle of the last execute()
+    // (0 if none was timed), timed with enablePacingSimulation or setSweepTarget()
+    void getFrameCosts(double& renderedFrameCost, double& generatedFrameCost);
+    const std::string& getOutputDirectory() const { return outputDirectory; }
+
+    int getRenderWidth() const { return renderWidth; }
+    int getRenderHeight() const { return renderHeight; }
+    int getPresentationWidth() const { return presentationWidth; }
+    int getPresentationHeight() const { return presentationHeight; }
+    // Outputs per submitted frame
+    int getCycleLength() const { return generatedFramesCount + 1; }
+
+    // External inputs (OpenGL backend, in the current context of the caller), nothing is read from or written to disk.
+    // Starts a new sequence, the programs and textures are created by the first call only. False if the OpenGL backend
+    // is not selected
+    bool beginFrames();
+    // Textures of render size, read in place until the next submitFrame(): color GL_RGBA8 (with super resolution the LR
+    // color rendered with the jitter offset, the pixel center p + 0.5 - jitter in LR pixels), depth in red as LoadDepth.comp
+    // writes it (depthScale/depthBias are not applied) and motion vectors in red/green as LoadMotionVector.comp writes
+    // them. Interpolation without super resolution keeps the color as history until the frame after, so colors alternate
+    // between two textures. Runs the rendered frame, false with an ERROR message if a texture does not match
+    bool submitFrame(GLuint color, GLuint depth, GLuint motionVector, float jitterX, float jitterY);
+    // Next output of the submitted frame in presentation order: the rendered frame (the previous one with interpolation),
+    // then the generated frames, each generated when received. nullptr after the last, and for the first submitted frame
+    // with interpolation. The texture is overwritten by the next receiveFrame() or submitFrame()
+    shared_ptr<Texture> receiveFrame();
+    // Caller textures (GL_RGBA8 of presentation size) written instead of the internal ones, before the first
+    // submitFrame(): the super resolution history alternates between the two historyTextures, which are the rendered
+    // outputs, and the generated frames are written to generatedTextures in turn. False with an ERROR message otherwise
+    bool setOutputTextures(const std::vector<GLuint>& historyTextures, const std::vector<GLuint>& generatedTextures);
+    void endFrames();
+
 private:
 
+    enum class Backend
+    {
+        OpenGL,     // Compute shaders
+        CPU,        // Multithreaded CPU implementation of the same stages (CpuBackend)
+        Validate,   // Both, saves the OpenGL outputs and compares them against the CPU outputs per frame
+    };
+
+    enum class FillMode
+    {
+        Full,       // Fill every LR pixel
+        HoleList,   // Fill only the pixels listed by Reproject_I (indirect dispatch)
+        PushPull,   // Fill every LR pixel, then fill remaining holes of any size from a min-depth pyramid
+    };
+
+    enum class ReprojectionEngine
+    {
+        Scatter,    // Clear, Reproject_I (atomic minimum per target pixel) and Fill
+        Gather,     // ReprojectGather_I: searches the source of every target pixel, one pass without atomics
+        RasterPoints,   // ReprojectRaster_I: one point per LR pixel, the depth test replaces the atomic minimum (OpenGL backend)
+        RasterMesh,     // Same on a triangle grid, small holes are covered by the triangles before Fill (OpenGL backend)
+    };
+
+    enum class DispatchOrder
+    {
+        RowMajor,   // gl_WorkGroupID as dispatched
+        Morton,     // Z-order inside blocks of 8x8 workgroups (dispatch padded to whole blocks)
+        Column,     // Columns 8 workgroups wide, scanned one after another
+    };
+
+    enum class ColorPrecision
+    {
+        FP32,           // 32-bit color math on desktop GL (mediump only applies to OpenGL ES)
+        FP16Emulated,   // 32-bit color math rounded to 16 bits through packHalf2x16, to measure the error on any GPU
+    };
+
+    enum class HashMode
+    {
+        Off,
+        Bitwise,    // Exact bits of every texel
+        Tolerance,  // Four 16-bit random projections of float textures, pass within an estimated RMS difference of hashTolerance (integer textures stay bitwise)
+    };
+
+    enum class ReprojectionFormat
+    {
+        Auto,       // Wide64 if the render size exceeds 2560x1440
+        Packed32,   // 11-bit depth, relative position within [-1024, 1023] x [-512, 511]
+        Wide64,     // 32-bit depth, relative position within [-32768, 32767]^2 (64-bit atomics or two passes)
+    };
+
     // Configuration
+    // Backend
+    Backend backend = Backend::OpenGL;
+    int cpuThreadCount = 0;             // 0 = all hardware threads
+    int validationTolerance = 2;        // Per channel difference (of 255) counted by Backend::Validate
     // Mode
     bool enableSuperResolution = false;
     bool enableInterpolation = true;
@@ -29,58 +142,85 @@ private:
     int startInputFrame = 10;
     int endInputFrame = 150;
     // LR Inputs (super resolution inputs)
-    const std::string inputLrDepthDirectory = "path/to/lr/depth/";
-    const std::string inputLrMotionVectorXDirectory = "path/to/lr/motion_vectors_x/";
-    const std::string inputLrMotionVectorYDirectory = "path/to/lr/motion_vectors_y/";
-    // HR Inputs (interpolation inputs and super resolution color input)
-    const std::string inputHrColorDirectory = "path/to/hr/color/";
-    const std::string inputHrDepthDirectory = "path/to/hr/depth/";
-    const std::string inputHrMotionVectorXDirectory = "path/to/hr/motion_vectors_x/";
-    const std::string inputHrMotionVectorYDirectory = "path/to/hr/motion_vectors_y/";
+    bool enableNativeLRColor = false;   // Rendered, already jittered LR color instead of sampling HR color
+    std::string inputLrColorDirectory = "path/to/lr/color/";
+    std::string inputLrJitterPath = "path/to/lr/jitter.txt";
+    std::string inputLrDepthDirectory = "path/to/lr/depth/";
+    std::string inputLrMotionVectorXDirectory = "path/to/lr/motion_vectors_x/";
+    std::string inputLrMotionVectorYDirectory = "path/to/lr/motion_vectors_y/";
+    // HR Inputs (interpolation inputs and super resolution color input without enableNativeLRColor)
+    std::string inputHrColorDirectory = "path/to/hr/color/";
+    std::string inputHrDepthDirectory = "path/to/hr/depth/";
+    std::string inputHrMotionVectorXDirectory = "path/to/hr/motion_vectors_x/";
+    std::string inputHrMotionVectorYDirectory = "path/to/hr/motion_vectors_y/";
+    // Camera motion (motion vectors reconstructed from depth and the view-projection matrices of inputCameraMatrixPath)
+    bool enableCameraMotionVectors = false;
+    bool enableSparseMotionVectors = false;     // Motion vector inputs of dynamic objects on top of the camera motion
+    std::string inputCameraMatrixPath = "path/to/camera.txt";
     // Outputs
-    const std::string outputDirectory = "path/to/outputs/";
+    std::string outputDirectory = "path/to/outputs/";
     // Resources (located in MobFGSR/resources/)
-    const std::string resourcesDirectory = "path/to/MobFGSR/resources/";
+    std::string resourcesDirectory = "path/to/MobFGSR/resources/";
     // Parameters
     float depthDiffThresholdSR = 0.01f;
     float colorDiffThresholdFG = 0.01f;
     float depthDiffThresholdFG = 0.004f;
     float depthScale = 1.0f;
     float depthBias = 0.0f;
+    // Optimizations
+    bool enableTileClassification = false;
+    FillMode fillMode = FillMode::Full;
+    ReprojectionFormat reprojectionFormat = ReprojectionFormat::Auto;
+    ReprojectionEngine reprojectionEngine = ReprojectionEngine::Scatter;
+    bool enableSubgroupShuffle = true;
+    bool enableLocalReprojection = false;   // Resolve colliding reprojection targets in shared memory first
+    DispatchOrder gatherDispatchOrder = DispatchOrder::RowMajor;   // Workgroup order of Warp_I and BlendHistory (OpenGL backend)
+    ColorPrecision colorPrecision = ColorPrecision::FP32;   // Warp_I, Copy_I, Warp_E, BlendHistory and UpsampleFirstFrame (OpenGL backend)
+    bool enableGeometryBuffer = false;  // Dilated depth and motion vectors in one RG32UI texture per frame (OpenGL backend)
+    // Diagnostics
+    bool enableReprojectionStats = false;   // Count reprojection atomics, printed at the end (OpenGL backend)
+    bool enableDispatchOrderBenchmark = false;  // Time Warp_I per DispatchOrder and motion scale after the last frame (OpenGL backend)
+    bool enablePrecisionReport = false;     // Compare the FP16 color kernels against FP32 every frame, printed at the end (OpenGL backend)
+    bool enableFrameStats = false;  // Kernel counters of every output frame, printed and written to stats.csv with the outputs (OpenGL backend)
+    // Intermediates written losslessly next to the outputs of frames [dumpStartFrame, dumpEndFrame), comma separated (OpenGL backend):
+    // inputDepth, inputMotionVector, dilatedDepth, dilatedMotionVector, reprojection, filledReprojection, resolvedMotion,
+    // frameGenerationResult, hrColor, history
+    std::string dumpResources = "";
+    int dumpStartFrame = 0;
+    int dumpEndFrame = 0;
+    // Simulate presentation with the measured GPU time of every pass of rendered, interpolated and extrapolated frames, printed at the end and written to
+    // pacing.csv (OpenGL backend). The extrapolation passes run next to every interpolated frame to be timed, their output is discarded
+    // (Backend::Validate compares it against the CPU backend).
+    // Render frame times in ms: renderFrameTime, or one per line of renderFrameTimeTracePath if set
+    bool enablePacingSimulation = false;
+    float renderFrameTime = 33.3f;
+    std::string renderFrameTimeTracePath = "";
+    // Hash the output and hashResources (dumpResources names, in pipeline order) of every output frame on the GPU, read back 8 bytes per texture,
+    // write them to hashes.txt with the outputs and compare against goldenHashPath if set, reporting the first diverging frame and texture (OpenGL backend)
+    HashMode hashMode = HashMode::Off;
+    float hashTolerance = 1.0f / 255.0f;
+    std::string hashResources = "";
+    std::string goldenHashPath = "";
 
     
-    struct vec4
-    {
-        float x;
-        float y;
-        float z;
-        float w;
-    };
-
-    struct vec2
-    {
-        float x;
-        float y;
+    const int localSize = 8;
 
-        vec2(): x(0), y(0) {}
-        vec2(float x, float y): x(x), y(y) {}
-    };
+    bool configured;
+    bool hasExternalInputs;
+    bool hasBegunFrames;
+    int submittedFrameCount;
+    // Cycle index of the next receiveFrame() output and output frame of the submitted rendered frame
+    int receiveCycleFrameIndex;
+    int cycleOutputFrame;
+    vec2 externalJitterOffset;
+    std::vector<shared_ptr<Texture>> generatedOutputs;
+    size_t generatedOutputIndex;
+    // Parses value as the type of the configuration member name and sets it, false with an ERROR message if it cannot
+    bool setOption(const std::string& name, const std::string& value);
 
-    struct alignas(16) UniformBlock
-    {
-        vec4 render_size;
-        vec4 presentation_size;
-        vec4 delta;
-        vec2 jitter_offset;
-        float depth_diff_threshold_sr;
-        float color_diff_threshold_fg;
-        float depth_diff_threshold_fg;
-        float depth_scale;
-        float depth_bias;
-        float render_scale;
-    };
-    
-    const int localSize = 8;
+    // Parameter sweep
+    shared_ptr<InputCache> inputCache;
+    std::function<void(int, const Texture&)> outputCallback;
 
     // Uniform buffer
     unsigned int uniformBuffer;
@@ -94,6 +234,9 @@ private:
     int groupX_HR;
     int groupY_HR;
     int groupZ_HR;
+    // HR dispatch of the gather kernels in gatherDispatchOrder
+    int groupX_HR_Gather;
+    int groupY_HR_Gather;
     
     int currentInputFrame;
     int currentOutputFrame;
@@ -120,18 +263,53 @@ private:
         vec2(-0.25f, -0.25f),
         vec2(+0.25f, +0.25f),
     };
+    // Per input frame jitter offsets of the native LR color, read from inputLrJitterPath
+    std::map<int, vec2> jitterOffsets;
+
+    // Per input frame view-projection matrices, read from inputCameraMatrixPath
+    std::map<int, mat4> viewProjections;
+    CameraBlock cameraBlock;
+    unsigned int cameraBuffer;
 
     // Compute shaders
     shared_ptr<ComputeShader> loadDepthCS;
     shared_ptr<ComputeShader> loadMotionVectorCS;
     shared_ptr<ComputeShader> loadLRColorCS;
+    shared_ptr<ComputeShader> reconstructMotionVectorCS;
     shared_ptr<ComputeShader> dilateCS;
     shared_ptr<ComputeShader> clearCS;
     shared_ptr<ComputeShader> reprojectCS_I;
+    shared_ptr<ComputeShader> reprojectPayloadCS_I;
+    shared_ptr<ComputeShader> reprojectGatherCS_I;
     shared_ptr<ComputeShader> fillCS;
+    shared_ptr<ComputeShader> resolveMotionCS_I;
     shared_ptr<ComputeShader> warpCS_I;
     shared_ptr<ComputeShader> upsampleFirstFrameCS;
     shared_ptr<ComputeShader> blendHistoryCS;
+    shared_ptr<ComputeShader> classifyTilesCS;
+    shared_ptr<ComputeShader> compactTilesCS;
+    shared_ptr<ComputeShader> copyCS_I;
+    shared_ptr<ComputeShader> applyFillCS;
+    shared_ptr<ComputeShader> pushFillCS;
+    shared_ptr<ComputeShader> pullFillCS;
+    // Extrapolation passes, only timed for enablePacingSimulation
+    shared_ptr<ComputeShader> clearCS_E;
+    shared_ptr<ComputeShader> reprojectCS_E;
+    shared_ptr<ComputeShader> fillCS_E;
+    shared_ptr<ComputeShader> warpCS_E;
+    // FP32 versions of the FP16 color kernels for enablePrecisionReport
+    shared_ptr<ComputeShader> warpReferenceCS_I;
+    shared_ptr<ComputeShader> copyReferenceCS_I;
+    shared_ptr<ComputeShader> warpReferenceCS_E;
+    shared_ptr<ComputeShader> upsampleFirstFrameReferenceCS;
+    shared_ptr<ComputeShader> blendHistoryReferenceCS;
+    // Texture hashes for hashMode: float and integer textures, 16-bit projections of HashMode::Tolerance
+    shared_ptr<ComputeShader> hashTextureCS;
+    shared_ptr<ComputeShader> hashUintTextureCS;
+    shared_ptr<ComputeShader> resolveProjectionHashCS;
+
+    // Raster shaders
+    shared_ptr<RasterShader> reprojectRasterRS_I;
 
     // Raw inputs
     shared_ptr<Texture> rawInputHRColor;
@@ -147,6 +325,9 @@ private:
     // LUTs
     shared_ptr<Texture> sampleLut;
 
+    // With enableGeometryBuffer the dilated depths are RG32UI geometry buffers (depth bits, packHalf2x16 motion vector)
+    // and the dilated motion vectors are unused
+
     // Current
     shared_ptr<Texture> currentDilatedDepth;
     shared_ptr<Texture> currentDilatedMotionVector;
@@ -159,21 +340,189 @@ private:
 
     // Frame generation
     shared_ptr<Texture> reprojection;
+    shared_ptr<StorageBuffer> wideReprojection;
     shared_ptr<Texture> filledReprojection;
+    shared_ptr<Texture> resolvedMotion;
     shared_ptr<Texture> frameGenerationResult;
+    // Targets of the timed extrapolation passes
+    shared_ptr<Texture> extrapolationReprojection;
+    shared_ptr<Texture> extrapolationFilledReprojection;
+    shared_ptr<Texture> extrapolationResult;
+
+    // Tile classification
+    int tileCountX;
+    int tileCountY;
+    shared_ptr<Texture> tileFlags;
+    shared_ptr<StorageBuffer> tileList;
+
+    // Hole list
+    shared_ptr<StorageBuffer> holeList;
+    shared_ptr<StorageBuffer> holeMask;
+
+    // Push-pull fill (level 0 is filledReprojection)
+    std::vector<shared_ptr<Texture>> pushPullLevels;
+
+    // Raster reprojection: framebuffer on reprojection with a depth buffer, vertices come from gl_VertexID
+    unsigned int reprojectionFramebuffer;
+    unsigned int reprojectionDepthBuffer;
+    unsigned int reprojectionVertexArray;
+    unsigned int reprojectionIndexBuffer;   // Triangle strip per LR row pair, separated by primitive restart
+    int reprojectionIndexCount;
+
+    // Reprojection stats (requests, global atomics, contended atomics), accumulated over all generated frames
+    shared_ptr<StorageBuffer> reprojectionStats;
+    int reprojectionStatsFrameCount;
+
+    // Frame stats: one counter buffer per frame in flight, read back once the fence after the frame has signaled
+    struct FrameStatsSlot
+    {
+        shared_ptr<StorageBuffer> counters;
+        GLsync fence;
+        int outputFrame;
+    };
+    std::vector<FrameStatsSlot> frameStatsSlots;
+    int frameStatsSlotIndex;
+    std::ofstream frameStatsFile;
+
+    // Dumps: texture reads into pixel buffers, written in order once their fence has signaled
+    struct DumpReadback
+    {
+        DumpHeader header;
+        unsigned int pixelBuffer;
+        GLsync fence;
+    };
+    std::vector<std::string> dumpResourceNames;
+    std::deque<DumpReadback> dumpReadbacks;
+
+    // Precision report: FP32 output of the kernel that just ran, and the error of each kernel over all frames
+    struct PrecisionError
+    {
+        int maxDiff;
+        double squaredErrorSum;
+        double valueCount;
+        double minPSNR;
+    };
+    shared_ptr<Texture> precisionReference;
+    std::map<std::string, PrecisionError> precisionErrors;
+
+    // Pacing simulation: GPU time of every pass of the output frames after the first cycle, resolved at the end
+    enum class PacingFrameType
+    {
+        Rendered,
+        Interpolated,
+        Extrapolated,
+    };
+    struct PacingPass
+    {
+        const char* name;           // nullptr for work outside the pipeline (precision references), not counted
+        PacingFrameType frameType;
+        unsigned int query;         // Timestamp at the end of the pass
+        double milliseconds;        // Host time at the end of the pass on OpenGL ES, then the time of the pass
+    };
+    struct PacingTiming
+    {
+        bool isRenderedFrame;
+        unsigned int beginQuery;
+        double beginMilliseconds;
+        std::vector<PacingPass> passes;
+    };
+    struct PacingPassCost
+    {
+        std::string name;
+        PacingFrameType frameType;
+        double milliseconds;        // Mean per frame of the type
+    };
+    std::vector<PacingTiming> pacingTimings;
+    // Passes are only timed between beginPacingTiming() and endPacingTiming()
+    bool isTimingPasses;
+    PacingFrameType pacingFrameType;
+
+    // Hashes: one 8-byte hash per texture (hashResourceNames, then the output) per frame in flight, read back once the
+    // fence after the frame has signaled
+    struct HashSlot
+    {
+        std::vector<shared_ptr<StorageBuffer>> hashes;
+        GLsync fence;
+        int outputFrame;
+    };
+    std::vector<HashSlot> hashSlots;
+    int hashSlotIndex;
+    std::vector<std::string> hashResourceNames;
+    std::map<std::pair<int, std::string>, unsigned long long> goldenHashes;
+    std::ofstream hashFile;
+    int hashedFrameCount;
+    int divergedFrameCount;
+    double maxHashDifference;
+    std::string firstDivergence;
 
     // Output
     shared_ptr<Texture> outputColor;
+
+    // CPU backend (Backend::CPU and Backend::Validate)
+    shared_ptr<CpuBackend> cpuBackend;
+    shared_ptr<CpuImage> cpuOutputColor;
+    shared_ptr<CpuImage> cpuExtrapolationColor;     // Backend::Validate with enablePacingSimulation, on generated frames
+    int validationMaxDiff;
+    double validationMinPSNR;
     
+    // Backend::CPU and Backend::Validate, by execute()
+    void initializeCPU();
+    void initializeOpenGL();
+    void loadJitterOffsets();
+    void loadViewProjections();
+    void updateCameraBlock();
     void load();
+    // Renders output frame cycleFrameIndex of the current input frame (0 = rendered frame, inputs loaded)
+    void renderOutputFrame(int cycleFrameIndex);
+    // After the last output frame of an input frame
+    void finishInputFrame();
     void render();
+    void renderOpenGL();
+    void renderCPU();
     void save();
+    void validate();
+    // Compare result against the CPU backend, label follows the frame number in the printed line
+    void validate(const std::string& label, const Texture& result, const CpuImage& cpuResult);
 
+    UniformBlock getUniformBlock() const;
     void bindUniformBuffer();
     void swapBuffers();
+    // Binds the dilated depths and motion vectors to the units a shader reads them from, -1 if it does not. A geometry
+    // buffer goes to the depth unit of its frame, or to the motion vector unit if the shader reads no depth.
+    void bindGeometry(int currentDepthUnit, int currentMotionVectorUnit, int previousDepthUnit, int previousMotionVectorUnit);
     void processInputs();
     void preprocess();
     void interpolate();
+    void pushPullFill();
+    void reprojectRaster();
+    void benchmarkDispatchOrders();
+    void reportPrecision(const std::string& kernel, const Texture& result);
+    void beginFrameStats();
+    void endFrameStats();
+    // Reads back and reports the oldest frame, waiting for its fence only with wait
+    void readFrameStats(FrameStatsSlot& slot, bool wait);
+    // Texture of a dumpResources name at the end of the frame, nullptr if unknown or not used in this configuration
+    shared_ptr<Texture> getDumpResource(const std::string& name) const;
+    // Comma separated dumpResources names that can be read back, with an ERROR for the others
+    std::vector<std::string> parseResourceNames(const std::string& list, const char* use) const;
+    void dumpFrame();
+    // Writes the finished dumps in order, waiting for them only with wait
+    void writeDumps(bool wait);
+    bool isTimingFrames() const { return enablePacingSimulation || static_cast<bool>(outputCallback); }
+    void beginPacingTiming();
+    void endPacingTiming();
+    // Timestamp after the passes since the previous one, name nullptr for work that is not counted
+    void endPacingPass(const char* name);
+    // Resolves and clears the timings, passes in the order they first ran
+    void getPassCosts(std::vector<PacingPassCost>& costs);
+    void extrapolate();
+    void reportPacing();
+    void hashFrame();
+    // Writes and compares the hashes of the oldest frame, waiting for its fence only with wait
+    void readHashes(HashSlot& slot, bool wait);
+    // False for frames without output and for the first interpolation cycle, whose outputs are overwritten
+    bool isFinalOutput() const { return outputColor && (!enableInterpolation || isFirstCycleCompleted); }
+    void interpolateTiled();
     void upsampleFirstFrame();
     void superSample();
 };
@@ -0,0 +1,119 @@
+#include "options.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static std::string trim(const std::string& s)
+{
+	const size_t begin = s.find_first_not_of(" \t\r");
+	if (begin == std::string::npos)
+	{
+		return "";
+	}
+	std::string result = s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+	if (result.size() >= 2 && result.front() == '"' && result.back() == '"')
+	{
+		result = result.substr(1, result.size() - 2);
+	}
+	return result;
+}
+
+bool parseOption(const std::string& text, std::pair<std::string, std::string>& option)
+{
+	const size_t separator = text.find('=');
+	if (separator == std::string::npos)
+	{
+		return false;
+	}
+	option.first = trim(text.substr(0, separator));
+	option.second = trim(text.substr(separator + 1));
+	return !option.first.empty();
+}
+
+bool loadOptions(const std::string& path, Options& options)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR: Failed to open " << path << std::endl;
+		return false;
+	}
+	std::string line;
+	for (int lineNumber = 1; std::getline(file, line); lineNumber++)
+	{
+		const std::string text = trim(line);
+		if (text.empty() || text[0] == '#')
+		{
+			continue;
+		}
+		std::pair<std::string, std::string> option;
+		if (!parseOption(text, option))
+		{
+			std::cout << "ERROR: Expected \"name = value\" in " << path << " line " << lineNumber << std::endl;
+			return false;
+		}
+		options.push_back(option);
+	}
+	return true;
+}
+
+bool parseArguments(int argc, char** argv, Options& options, Arguments& arguments)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--config") == 0 && hasValue)
+		{
+			if (!loadOptions(argv[++i], options))
+			{
+				return false;
+			}
+			continue;
+		}
+		if (strcmp(argv[i], "--sweep") == 0 && hasValue)
+		{
+			arguments.sweepPath = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--reference") == 0 && hasValue)
+		{
+			arguments.referenceDirectory = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--serve") == 0 && hasValue)
+		{
+			arguments.socketPath = argv[++i];
+			continue;
+		}
+		std::pair<std::string, std::string> option;
+		if (!parseOption(argv[i], option))
+		{
+			std::cout << "ERROR: Unknown argument " << argv[i] << ", expected name=value, --config <file>, --sweep <file>, --reference <directory> or --serve <socket>" << std::endl;
+			return false;
+		}
+		options.push_back(option);
+	}
+	return true;
+}
+
+std::vector<std::string> splitValues(const std::string& values)
+{
+	std::vector<std::string> result;
+	size_t begin = 0;
+	while (begin <= values.size())
+	{
+		size_t end = values.find(',', begin);
+		if (end == std::string::npos)
+		{
+			end = values.size();
+		}
+		const std::string value = trim(values.substr(begin, end - begin));
+		if (!value.empty())
+		{
+			result.push_back(value);
+		}
+		begin = end + 1;
+	}
+	return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+// Configuration members of OffscreenRenderer by name and value, applied in order (later values win)
+typedef std::vector<std::pair<std::string, std::string>> Options;
+
+// "name = value" per line, blank lines and lines starting with '#' are skipped, values may be quoted. False with an
+// ERROR message if the file cannot be read or a line has no '='
+bool loadOptions(const std::string& path, Options& options);
+
+// "name = value" (spaces and quotes trimmed), false without '=' or name
+bool parseOption(const std::string& text, std::pair<std::string, std::string>& option);
+
+// Command line arguments besides the configuration
+struct Arguments
+{
+	// ParameterSweep: --sweep <file> and --reference <directory>
+	std::string sweepPath;
+	std::string referenceDirectory;
+	// FrameServer: --serve <socket path>
+	std::string socketPath;
+};
+
+// "name=value" arguments and "--config <file>" (loaded in place), the others go to arguments. False with an ERROR
+// message on malformed arguments
+bool parseArguments(int argc, char** argv, Options& options, Arguments& arguments);
+
+// Comma separated values, trimmed
+std::vector<std::string> splitValues(const std::string& values);
@@ -0,0 +1,117 @@
+#include "pacing_simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+PacingSimulator::PacingSimulator(const std::vector<double>& frameTimes, double renderedCost, double interpolatedCost, double extrapolatedCost) :
+	renderFrameTimes(frameTimes), renderedFrameCost(renderedCost), interpolatedFrameCost(interpolatedCost), extrapolatedFrameCost(extrapolatedCost)
+{
+}
+
+bool PacingSimulator::loadFrameTimeTrace(const std::string& path, int minFrameCount, std::vector<double>& frameTimes)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR: Failed to open frame time trace " << path << std::endl;
+		return false;
+	}
+	std::vector<double> trace;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream ss(line);
+		double frameTime;
+		if (ss >> frameTime && frameTime > 0.0)
+		{
+			trace.push_back(frameTime);
+		}
+	}
+	if (trace.empty())
+	{
+		std::cout << "ERROR: No frame times in " << path << std::endl;
+		return false;
+	}
+	frameTimes.clear();
+	const int frameCount = std::max(minFrameCount, static_cast<int>(trace.size()));
+	for (int i = 0; i < frameCount; i++)
+	{
+		frameTimes.push_back(trace[i % trace.size()]);
+	}
+	return true;
+}
+
+std::vector<PacingSimulator::OutputFrame> PacingSimulator::simulate(Mode mode, int generatedFramesCount) const
+{
+	const double generatedFrameCost = mode == Mode::Interpolation ? interpolatedFrameCost : extrapolatedFrameCost;
+	std::vector<OutputFrame> frames;
+	double renderedTime = 0.0;
+	double gpuIdleTime = 0.0;
+	double previousInputTime = 0.0;
+	double previousPresentTime = -1.0;
+	for (int k = 0; k < static_cast<int>(renderFrameTimes.size()); k++)
+	{
+		const double frameTime = renderFrameTimes[k];
+		renderedTime = std::max(renderedTime + frameTime, gpuIdleTime);
+		const double inputTime = renderedTime - frameTime;
+		const double processedTime = renderedTime + renderedFrameCost;
+		gpuIdleTime = processedTime + generatedFrameCost * generatedFramesCount;
+
+		// Interpolation needs the next rendered frame, so the first one has no outputs
+		if (mode == Mode::Interpolation && k == 0)
+		{
+			previousInputTime = inputTime;
+			continue;
+		}
+		const double outputInterval = frameTime / (generatedFramesCount + 1);
+		for (int i = 0; i <= generatedFramesCount; i++)
+		{
+			OutputFrame frame;
+			frame.generatedIndex = i;
+			frame.sourceFrame = mode == Mode::Interpolation && i == 0 ? k - 1 : k;
+			frame.readyTime = processedTime + generatedFrameCost * i;
+			frame.presentTime = previousPresentTime < 0.0 ? frame.readyTime : std::max(frame.readyTime, previousPresentTime + outputInterval);
+			frame.latency = frame.presentTime - (frame.sourceFrame == k ? inputTime : previousInputTime);
+			previousPresentTime = frame.presentTime;
+			frames.push_back(frame);
+		}
+		previousInputTime = inputTime;
+	}
+	return frames;
+}
+
+PacingSimulator::Summary PacingSimulator::summarize(const std::vector<OutputFrame>& frames)
+{
+	Summary summary = {};
+	summary.outputCount = static_cast<int>(frames.size());
+	if (frames.empty())
+	{
+		return summary;
+	}
+	for (const OutputFrame& frame : frames)
+	{
+		summary.meanLatency += frame.latency;
+		summary.maxLatency = std::max(summary.maxLatency, frame.latency);
+	}
+	summary.meanLatency /= frames.size();
+	if (frames.size() < 2)
+	{
+		return summary;
+	}
+	const double duration = frames.back().presentTime - frames.front().presentTime;
+	const size_t intervalCount = frames.size() - 1;
+	summary.outputRate = duration > 0.0 ? 1000.0 * intervalCount / duration : 0.0;
+	summary.meanInterval = duration / intervalCount;
+	double squaredDeviationSum = 0.0;
+	for (size_t i = 1; i < frames.size(); i++)
+	{
+		const double interval = frames[i].presentTime - frames[i - 1].presentTime;
+		squaredDeviationSum += (interval - summary.meanInterval) * (interval - summary.meanInterval);
+		summary.maxInterval = std::max(summary.maxInterval, interval);
+	}
+	summary.intervalJitter = std::sqrt(squaredDeviationSum / intervalCount);
+	return summary;
+}
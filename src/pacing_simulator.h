@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Present timeline of the outputs for a render frame-time model and the GPU cost of the pipeline, to weigh latency and
+// pacing of interpolation against extrapolation and of the number of generated frames. All times are in ms.
+//
+// Rendered frame k completes at R(k) = max(R(k - 1) + frameTime(k), end of the passes of frame k - 1) and samples its
+// input at R(k) - frameTime(k). Its passes (renderedFrameCost, then interpolatedFrameCost or extrapolatedFrameCost per
+// generated frame) run right after it on the same GPU. Interpolation outputs frame k - 1 and the frames generated between
+// k - 1 and k once frame k is processed, extrapolation outputs frame k and the frames generated past it. Outputs are
+// presented when ready, but no earlier than one output interval (frameTime(k) / (generatedFramesCount + 1)) after the
+// previous one. Latency is measured from the input of the newest rendered frame an output is made from.
+class PacingSimulator
+{
+public:
+	enum class Mode
+	{
+		Interpolation,
+		Extrapolation
+	};
+
+	struct OutputFrame
+	{
+		int sourceFrame;        // Rendered frame, or the newest one used by a generated frame
+		int generatedIndex;     // 0 for rendered frames
+		double readyTime;
+		double presentTime;
+		double latency;
+	};
+
+	struct Summary
+	{
+		int outputCount;
+		double outputRate;      // Frames per second
+		double meanLatency;
+		double maxLatency;
+		double meanInterval;
+		double intervalJitter;  // Standard deviation of the present intervals
+		double maxInterval;
+	};
+
+	PacingSimulator(const std::vector<double>& renderFrameTimes, double renderedFrameCost, double interpolatedFrameCost,
+		double extrapolatedFrameCost);
+
+	// One frame time per line, cycled up to minFrameCount frames. False with an ERROR message if there are none.
+	static bool loadFrameTimeTrace(const std::string& path, int minFrameCount, std::vector<double>& frameTimes);
+
+	std::vector<OutputFrame> simulate(Mode mode, int generatedFramesCount) const;
+
+	static Summary summarize(const std::vector<OutputFrame>& frames);
+private:
+	std::vector<double> renderFrameTimes;
+	double renderedFrameCost;
+	double interpolatedFrameCost;
+	double extrapolatedFrameCost;
+};
@@ -0,0 +1,187 @@
+#include "parameter_sweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+#include "input_cache.h"
+#include "offscreen_renderer.h"
+#include "stb_image.h"
+
+static double computePSNR(double squaredErrorSum, double valueCount)
+{
+	return squaredErrorSum > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * valueCount / squaredErrorSum) : std::numeric_limits<double>::infinity();
+}
+
+bool ParameterSweep::loadParameters(const std::string& path, Parameters& parameters)
+{
+	Options lines;
+	if (!loadOptions(path, lines))
+	{
+		return false;
+	}
+	for (const auto& line : lines)
+	{
+		const std::vector<std::string> values = splitValues(line.second);
+		if (values.empty())
+		{
+			std::cout << "ERROR: No values for " << line.first << " in " << path << std::endl;
+			return false;
+		}
+		parameters.push_back(std::make_pair(line.first, values));
+	}
+	return true;
+}
+
+ParameterSweep::ParameterSweep(const Options& baseOptions, const Parameters& parameters, const std::string& referenceDirectory)
+	: baseOptions(baseOptions), parameters(parameters), referenceDirectory(referenceDirectory)
+{
+	if (!this->referenceDirectory.empty() && this->referenceDirectory.back() != '/' && this->referenceDirectory.back() != '\\')
+	{
+		this->referenceDirectory += '/';
+	}
+}
+
+bool ParameterSweep::run()
+{
+	int combinationCount = 1;
+	for (const auto& parameter : parameters)
+	{
+		// The input cache and the output callback are OpenGL textures
+		if (parameter.first == "backend")
+		{
+			std::cout << "ERROR: backend cannot be swept" << std::endl;
+			return false;
+		}
+		combinationCount *= static_cast<int>(parameter.second.size());
+	}
+
+	// Inputs are cached by path: parameters changing the size of an input decode it again
+	shared_ptr<InputCache> inputCache = make_shared<InputCache>();
+	std::ofstream file;
+	for (int combination = 0; combination < combinationCount; combination++)
+	{
+		Options options = baseOptions;
+		std::vector<std::string> values(parameters.size());
+		for (int i = static_cast<int>(parameters.size()) - 1, index = combination; i >= 0; i--)
+		{
+			const std::vector<std::string>& parameterValues = parameters[i].second;
+			values[i] = parameterValues[index % parameterValues.size()];
+			index /= static_cast<int>(parameterValues.size());
+			options.push_back(std::make_pair(parameters[i].first, values[i]));
+		}
+
+		OffscreenRenderer renderer(options);
+		if (!renderer.isConfigured())
+		{
+			return false;
+		}
+		if (!renderer.requiresOpenGL())
+		{
+			std::cout << "ERROR: Parameter sweeps need Backend::OpenGL" << std::endl;
+			return false;
+		}
+		if (!file.is_open())
+		{
+			const std::string path = renderer.getOutputDirectory() + "sweep.csv";
+			file.open(path);
+			if (!file)
+			{
+				std::cout << "ERROR: Failed to open " << path << std::endl;
+				return false;
+			}
+			file << "combination";
+			for (const auto& parameter : parameters)
+			{
+				file << "," << parameter.first;
+			}
+			file << ",rendered_ms,generated_ms,frames,psnr,min_psnr,max_diff" << std::endl;
+		}
+
+		Quality quality = { 0.0, 0.0, std::numeric_limits<double>::infinity(), 0, 0 };
+		std::vector<unsigned char> pixels;
+		renderer.setSweepTarget(inputCache, [&](int outputFrame, const Texture& color)
+		{
+			pixels.resize(static_cast<size_t>(color.getWidth()) * color.getHeight() * 4);
+			color.getImage(GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+			if (referenceDirectory.empty() && combination == 0)
+			{
+				references[outputFrame] = pixels;
+			}
+			compare(outputFrame, pixels.data(), color.getWidth(), color.getHeight(), quality);
+		});
+		renderer.execute();
+
+		double renderedFrameCost, generatedFrameCost;
+		renderer.getFrameCosts(renderedFrameCost, generatedFrameCost);
+		const double psnr = computePSNR(quality.squaredErrorSum, quality.valueCount);
+
+		std::cout << "Combination " << combination << " of " << combinationCount << ":";
+		file << combination;
+		for (size_t i = 0; i < parameters.size(); i++)
+		{
+			std::cout << " " << parameters[i].first << "=" << values[i];
+			file << "," << values[i];
+		}
+		std::cout << ", " << renderedFrameCost << " ms per rendered frame, " << generatedFrameCost << " ms per generated frame, PSNR "
+			<< psnr << " dB (min " << quality.minPSNR << " dB, max diff " << quality.maxDiff << ") over " << quality.frameCount << " frames" << std::endl;
+		file << "," << renderedFrameCost << "," << generatedFrameCost << "," << quality.frameCount << "," << psnr << ","
+			<< quality.minPSNR << "," << quality.maxDiff << std::endl;
+	}
+	std::cout << "Decoded " << inputCache->getImageCount() << " input images for " << combinationCount << " combinations" << std::endl;
+	return true;
+}
+
+void ParameterSweep::compare(int outputFrame, const unsigned char* pixels, int width, int height, Quality& quality)
+{
+	auto reference = references.find(outputFrame);
+	if (reference == references.end())
+	{
+		std::vector<unsigned char> image;
+		if (!referenceDirectory.empty())
+		{
+			char fileName[16];
+			snprintf(fileName, sizeof(fileName), "%04d.png", outputFrame);
+			const std::string path = referenceDirectory + fileName;
+			int w, h, channels;
+			unsigned char* data = stbi_load(path.c_str(), &w, &h, &channels, 4);
+			if (!data || w != width || h != height)
+			{
+				std::cout << "ERROR: No " << width << "x" << height << " reference at " << path << std::endl;
+			}
+			else
+			{
+				image.assign(data, data + static_cast<size_t>(w) * h * 4);
+			}
+			stbi_image_free(data);
+		}
+		reference = references.insert(std::make_pair(outputFrame, image)).first;
+	}
+	const std::vector<unsigned char>& expected = reference->second;
+	if (expected.size() != static_cast<size_t>(width) * height * 4)
+	{
+		return;
+	}
+
+	double squaredErrorSum = 0.0;
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		if (i % 4 == 3)
+		{
+			continue;
+		}
+		const int diff = std::abs(static_cast<int>(pixels[i]) - static_cast<int>(expected[i]));
+		quality.maxDiff = std::max(quality.maxDiff, diff);
+		squaredErrorSum += static_cast<double>(diff * diff);
+	}
+	const double valueCount = static_cast<double>(expected.size() / 4 * 3);
+	quality.squaredErrorSum += squaredErrorSum;
+	quality.valueCount += valueCount;
+	quality.minPSNR = std::min(quality.minPSNR, computePSNR(squaredErrorSum, valueCount));
+	quality.frameCount++;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "options.h"
+
+// Runs OffscreenRenderer once per combination of the swept parameter values over the same inputs, decoded once and
+// kept on the GPU, and writes the GPU time and the PSNR of every combination to sweep.csv in the output directory.
+// The PSNR is measured against <referenceDirectory>/<output frame>.png, or against the first combination without it.
+class ParameterSweep
+{
+public:
+	// Swept names and their values, the last name changes fastest
+	typedef std::vector<std::pair<std::string, std::vector<std::string>>> Parameters;
+
+	// "name = value, value, ..." per line, in the format of loadOptions
+	static bool loadParameters(const std::string& path, Parameters& parameters);
+
+	ParameterSweep(const Options& baseOptions, const Parameters& parameters, const std::string& referenceDirectory);
+
+	// Needs a current OpenGL context. False with an ERROR message if the options are invalid or select no OpenGL backend
+	bool run();
+private:
+	struct Quality
+	{
+		double squaredErrorSum;
+		double valueCount;
+		double minPSNR;
+		int maxDiff;
+		int frameCount;
+	};
+
+	void compare(int outputFrame, const unsigned char* pixels, int width, int height, Quality& quality);
+
+	Options baseOptions;
+	Parameters parameters;
+	std::string referenceDirectory;
+	// RGBA8 reference per output frame, empty if it could not be loaded
+	std::map<int, std::vector<unsigned char>> references;
+};
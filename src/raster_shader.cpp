@@ -0,0 +1,56 @@
+﻿#include "raster_shader.h"
+
+#include <iostream>
+#include <glad/glad.h>
+#include "compute_shader.h"
+
+static unsigned int compileShader(GLenum type, const std::string& shaderPath, const std::vector<std::string>& defines)
+{
+	const std::string shaderCode = loadShaderSource(shaderPath, defines);
+	const char* source = shaderCode.c_str();
+
+	int success;
+	char infoLog[1024];
+
+	unsigned int shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+		std::cout << "ERROR: Shader compilation failed in " << shaderPath << "\n" << infoLog << "\n";
+	}
+	return shader;
+}
+
+RasterShader::RasterShader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::vector<std::string>& defines)
+{
+	unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderPath, defines);
+	unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderPath, defines);
+
+	int success;
+	char infoLog[1024];
+
+	shaderID = glCreateProgram();
+	glAttachShader(shaderID, vertexShader);
+	glAttachShader(shaderID, fragmentShader);
+	glLinkProgram(shaderID);
+	glGetProgramiv(shaderID, GL_LINK_STATUS, &success);
+	if (!success) {
+		glGetProgramInfoLog(shaderID, 1024, NULL, infoLog);
+		std::cout << "ERROR: Shader linking failed in " << vertexShaderPath << ", " << fragmentShaderPath << "\n" << infoLog << "\n";
+	}
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+}
+
+RasterShader::~RasterShader()
+{
+	glDeleteProgram(shaderID);
+}
+
+void RasterShader::use() const
+{
+	glUseProgram(shaderID);
+}
@@ -0,0 +1,17 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+
+// Vertex and fragment shader program for the passes that rasterize instead of running a compute shader
+class RasterShader
+{
+public:
+    // Defines are inserted into both stages like in ComputeShader
+    RasterShader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::vector<std::string>& defines = {});
+    ~RasterShader();
+
+    unsigned int getID() const { return shaderID; }
+    void use() const;
+private:
+    unsigned int shaderID;
+};
@@ -0,0 +1,46 @@
+#include "storage_buffer.h"
+#include <cstring>
+
+StorageBuffer::StorageBuffer(GLsizeiptr s, const void* data, GLenum usage) :
+	size(s)
+{
+	glGenBuffers(1, &bufferID);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, usage);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+StorageBuffer::~StorageBuffer()
+{
+	glDeleteBuffers(1, &bufferID);
+}
+
+void StorageBuffer::setData(GLintptr offset, GLsizeiptr dataSize, const void* data) const
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferID);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, dataSize, data);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void StorageBuffer::getData(GLintptr offset, GLsizeiptr dataSize, void* data) const
+{
+	// Mapped, glGetBufferSubData is not available in OpenGL ES
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferID);
+	const void* mapped = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, offset, dataSize, GL_MAP_READ_BIT);
+	if (mapped)
+	{
+		memcpy(data, mapped, static_cast<size_t>(dataSize));
+		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void StorageBuffer::bindBase(GLuint binding) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, bufferID);
+}
+
+void StorageBuffer::bindIndirect() const
+{
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, bufferID);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <glad/glad.h>
+
+class StorageBuffer
+{
+public:
+	StorageBuffer(GLsizeiptr size, const void* data = nullptr, GLenum usage = GL_DYNAMIC_DRAW);
+
+	~StorageBuffer();
+
+	void setData(GLintptr offset, GLsizeiptr size, const void* data) const;
+
+	void getData(GLintptr offset, GLsizeiptr size, void* data) const;
+
+	void bindBase(GLuint binding) const;
+
+	void bindIndirect() const;
+
+	unsigned int getID() const { return bufferID; }
+
+	GLsizeiptr getSize() const { return size; }
+private:
+	unsigned int bufferID;
+	GLsizeiptr size;
+};
@@ -15,8 +15,19 @@
 
 
 Texture::Texture(GLenum format, GLsizei w, GLsizei h, GLint filter) :
-	internalFormat(format), width(w), height(h)
+	internalFormat(format), width(w), height(h), isOwner(true)
 {
+#ifdef ENABLE_GLES
+	// OpenGL ES 3.1 has no two-channel image load/store formats
+	if (internalFormat == GL_RG16F)
+	{
+		internalFormat = GL_RGBA16F;
+	}
+	else if (internalFormat == GL_RG32UI)
+	{
+		internalFormat = GL_RGBA32UI;
+	}
+#endif
 	glGenTextures(1, &textureID);
 	glBindTexture(GL_TEXTURE_2D, textureID);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -27,9 +38,24 @@ Texture::Texture(GLenum format, GLsizei w, GLsizei h, GLint filter) :
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+Texture::Texture(GLuint existingTextureID) :
+	textureID(existingTextureID), isOwner(false)
+{
+	GLint format = 0;
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	internalFormat = static_cast<GLenum>(format);
+}
+
 Texture::~Texture()
 {
-	glDeleteTextures(0, &textureID);
+	if (isOwner)
+	{
+		glDeleteTextures(1, &textureID);
+	}
 }
 
 void Texture::loadFromFile(const std::string& path, GLenum sourceFormat, GLenum sourceType, bool flipVertical)
@@ -39,7 +65,14 @@ void Texture::loadFromFile(const std::string& path, GLenum sourceFormat, GLenum
 		stbi_set_flip_vertically_on_load(true);
 	}
 	int w, h, c;
-	unsigned char* data = stbi_load(path.c_str(), &w, &h, &c, 0);
+#ifdef ENABLE_GLES
+	// RGBA8 only accepts RGBA uploads in OpenGL ES
+	if (sourceFormat == GL_RGB && sourceType == GL_UNSIGNED_BYTE)
+	{
+		sourceFormat = GL_RGBA;
+	}
+#endif
+	unsigned char* data = stbi_load(path.c_str(), &w, &h, &c, sourceFormat == GL_RGBA ? 4 : 0);
 	if (data)
 	{
 		glBindTexture(GL_TEXTURE_2D, textureID);
@@ -53,6 +86,13 @@ void Texture::loadFromFile(const std::string& path, GLenum sourceFormat, GLenum
 	stbi_image_free(data);
 }
 
+void Texture::loadFromMemory(const void* data, GLenum sourceFormat, GLenum sourceType)
+{
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, sourceFormat, sourceType, data);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void Texture::loadLUT(const std::string& path)
 {
 	int width, height;
@@ -91,11 +131,45 @@ void Texture::bindTexture(GLenum textureUnit) const
 	glBindTexture(GL_TEXTURE_2D, textureID);
 }
 
+void Texture::copyFrom(const Texture& source, GLsizei w, GLsizei h)
+{
+#ifdef ENABLE_GLES
+	// glCopyImageSubData needs OpenGL ES 3.2
+	GLuint framebuffer;
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source.textureID, 0);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, w, h);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(1, &framebuffer);
+#else
+	glCopyImageSubData(source.textureID, GL_TEXTURE_2D, 0, 0, 0, 0, textureID, GL_TEXTURE_2D, 0, 0, 0, 0, w, h, 1);
+#endif
+}
+
+void Texture::getImage(GLenum format, GLenum type, void* data) const
+{
+	// Through a framebuffer, glGetTexImage is not available in OpenGL ES
+	GLuint framebuffer;
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureID, 0);
+	// Tightly packed rows, the caller's pack alignment is restored afterwards
+	GLint packAlignment;
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, format, type, data);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(1, &framebuffer);
+}
+
 void Texture::saveAsPNG(const char* path, int sourcePixelSize) const
 {
 	GLubyte* data = new GLubyte[width * height * sourcePixelSize];
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	getImage(GL_RGBA, GL_UNSIGNED_BYTE, data);
 	stbi_write_png(path, width, height, 4, data, 0);
 	delete[] data;
 }
@@ -103,8 +177,7 @@ void Texture::saveAsPNG(const char* path, int sourcePixelSize) const
 void Texture::saveLUT(const char* path) const
 {
 	float* data = new float[width * height];
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, data);
+	getImage(GL_RED, GL_FLOAT, data);
 
 	const char* err;
 	SaveEXR(data, width, height, 1, 0, path, &err);
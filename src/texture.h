@@ -7,18 +7,36 @@ class Texture
 public:
 	Texture(GLenum format, GLsizei width, GLsizei height, GLint filter);
 
+	// Refers to an existing 2D texture without owning it, format and size are queried
+	explicit Texture(GLuint existingTextureID);
+
 	~Texture();
 
 	void loadFromFile(const std::string& path, GLenum sourceFormat, GLenum sourceType, bool flipVertical = false);
 
+	void loadFromMemory(const void* data, GLenum sourceFormat, GLenum sourceType);
+
 	void loadLUT(const std::string& path);
 
 	void bindImageUnit(GLuint imageUnit, GLenum access) const;
 
 	void bindTexture(GLenum textureUnit) const;
 
+	// Copies the w x h top-left texels of source (same format)
+	void copyFrom(const Texture& source, GLsizei w, GLsizei h);
+
 	unsigned int getID() const { return textureID; }
 
+	// Internal format after the OpenGL ES substitutions
+	GLenum getFormat() const { return internalFormat; }
+
+	int getWidth() const { return width; }
+
+	int getHeight() const { return height; }
+
+	// With a GL_PIXEL_PACK_BUFFER bound, data is an offset into it and the read does not wait for the GPU
+	void getImage(GLenum format, GLenum type, void* data) const;
+
 	void saveAsPNG(const char* path, int sourcePixelSize = 4) const;
 
 	void saveLUT(const char* path) const;
@@ -27,5 +45,6 @@ private:
 	GLenum internalFormat;
 	int width;
 	int height;
+	bool isOwner;
 };
 
@@ -0,0 +1,160 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+static uint64_t packRange(uint32_t begin, uint32_t end)
+{
+	return static_cast<uint64_t>(begin) | (static_cast<uint64_t>(end) << 32);
+}
+
+ThreadPool::ThreadPool(int threadCount) :
+	threadCount(threadCount), job(nullptr), generation(0), busyWorkers(0), stopping(false)
+{
+	if (this->threadCount <= 0)
+	{
+		this->threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	ranges.reset(new std::atomic<uint64_t>[this->threadCount]);
+	for (int i = 0; i < this->threadCount; i++)
+	{
+		ranges[i].store(0);
+	}
+	// Thread 0 is the caller of parallelFor()
+	for (int i = 1; i < this->threadCount; i++)
+	{
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	startCondition.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::parallelFor(int itemCount, const std::function<void(int)>& func)
+{
+	if (itemCount <= 0)
+	{
+		return;
+	}
+	if (threadCount == 1 || itemCount == 1)
+	{
+		for (int i = 0; i < itemCount; i++)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		const uint32_t begin = static_cast<uint32_t>(static_cast<int64_t>(itemCount) * i / threadCount);
+		const uint32_t end = static_cast<uint32_t>(static_cast<int64_t>(itemCount) * (i + 1) / threadCount);
+		ranges[i].store(packRange(begin, end));
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &func;
+		busyWorkers = threadCount - 1;
+		generation++;
+	}
+	startCondition.notify_all();
+
+	runJob(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finishCondition.wait(lock, [this] { return busyWorkers == 0; });
+	job = nullptr;
+}
+
+void ThreadPool::workerLoop(int threadIndex)
+{
+	uint64_t finishedGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			startCondition.wait(lock, [&] { return stopping || generation != finishedGeneration; });
+			if (stopping)
+			{
+				return;
+			}
+			finishedGeneration = generation;
+		}
+
+		runJob(threadIndex);
+
+		bool isLast;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isLast = --busyWorkers == 0;
+		}
+		if (isLast)
+		{
+			finishCondition.notify_one();
+		}
+	}
+}
+
+void ThreadPool::runJob(int threadIndex)
+{
+	int item;
+	while (popFront(threadIndex, item))
+	{
+		(*job)(item);
+	}
+	// Steal from the other threads, nearest first
+	for (int i = 1; i < threadCount; i++)
+	{
+		const int victim = (threadIndex + i) % threadCount;
+		while (popBack(victim, item))
+		{
+			(*job)(item);
+		}
+	}
+}
+
+bool ThreadPool::popFront(int rangeIndex, int& item)
+{
+	uint64_t range = ranges[rangeIndex].load();
+	for (;;)
+	{
+		const uint32_t begin = static_cast<uint32_t>(range);
+		const uint32_t end = static_cast<uint32_t>(range >> 32);
+		if (begin >= end)
+		{
+			return false;
+		}
+		if (ranges[rangeIndex].compare_exchange_weak(range, packRange(begin + 1, end)))
+		{
+			item = static_cast<int>(begin);
+			return true;
+		}
+	}
+}
+
+bool ThreadPool::popBack(int rangeIndex, int& item)
+{
+	uint64_t range = ranges[rangeIndex].load();
+	for (;;)
+	{
+		const uint32_t begin = static_cast<uint32_t>(range);
+		const uint32_t end = static_cast<uint32_t>(range >> 32);
+		if (begin >= end)
+		{
+			return false;
+		}
+		if (ranges[rangeIndex].compare_exchange_weak(range, packRange(begin, end - 1)))
+		{
+			item = static_cast<int>(end - 1);
+			return true;
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data parallel loops. parallelFor() splits the items into one contiguous range per
+// thread; a thread that finishes its range steals items from the end of the other ranges. The calling thread works too.
+class ThreadPool
+{
+public:
+	// threadCount <= 0 uses all hardware threads
+	explicit ThreadPool(int threadCount = 0);
+
+	~ThreadPool();
+
+	// Calls func(item) once for every item in [0, itemCount) and returns when all calls are done
+	void parallelFor(int itemCount, const std::function<void(int)>& func);
+
+	int getThreadCount() const { return threadCount; }
+private:
+	int threadCount;
+	std::vector<std::thread> workers;
+	// Remaining items of each thread, begin in the low and end in the high 32 bits
+	std::unique_ptr<std::atomic<uint64_t>[]> ranges;
+
+	std::mutex mutex;
+	std::condition_variable startCondition;
+	std::condition_variable finishCondition;
+	const std::function<void(int)>* job;
+	uint64_t generation;
+	int busyWorkers;
+	bool stopping;
+
+	void workerLoop(int threadIndex);
+	void runJob(int threadIndex);
+	bool popFront(int rangeIndex, int& item);
+	bool popBack(int rangeIndex, int& item);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+struct vec4
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+struct vec2
+{
+	float x;
+	float y;
+
+	vec2(): x(0), y(0) {}
+	vec2(float x, float y): x(x), y(y) {}
+};
+
+// Contents of the cb_t uniform block (binding 10, std140), also passed to the CPU backend
+struct alignas(16) UniformBlock
+{
+	vec4 render_size;
+	vec4 presentation_size;
+	vec4 delta;
+	vec2 jitter_offset;
+	float depth_diff_threshold_sr;
+	float color_diff_threshold_fg;
+	float depth_diff_threshold_fg;
+	float depth_scale;
+	float depth_bias;
+	float render_scale;
+};
+
+// Column-major like GLSL
+struct mat4
+{
+	float m[16];
+};
+
+// Contents of the cb_camera_t uniform block (binding 15, std140) of ReconstructMotionVector
+struct alignas(16) CameraBlock
+{
+	// Current NDC (pixel center, depth * 2 - 1) -> previous clip space, the jitter of the current frame included
+	mat4 reprojection;
+};
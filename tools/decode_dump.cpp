@@ -0,0 +1,202 @@
+// Decodes a dump written by OffscreenRenderer for dumpResources to EXR images:
+//   reprojection, filledReprojection: <prefix>_depth.exr (-1 where nothing was reprojected) and <prefix>_offset.exr
+//     (target - source position in LR pixels, 1 in blue where valid), from the packed 11/11/10 or the wide 64-bit format
+//   dilatedDepth of the geometry buffer: <prefix>_depth.exr and <prefix>_motion_vector.exr
+//   resolvedMotion: <prefix>_motion_t1.exr and <prefix>_motion_t0.exr (1 in blue where the quadratic estimation has t0)
+//   anything else: <prefix>.exr with every channel as float (RGBA8 normalized)
+// Usage: DecodeDump <file.dump> [output prefix, the dump path without .dump by default]
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#define TINYEXR_USE_MINIZ 0
+#define TINYEXR_USE_STB_ZLIB 1
+#define TINYEXR_IMPLEMENTATION
+#include "tinyexr.h"
+
+#include "dump_file.h"
+
+// Packing constants of Reproject_I
+static const uint32_t invalidReprojection = 0xFFFFFFFFu;
+static const uint32_t depthBits = 11;
+static const uint32_t xBits = 11;
+static const uint32_t yBits = 10;
+
+static float uintBitsToFloat(uint32_t bits)
+{
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static float halfToFloat(uint16_t half)
+{
+	const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+	const uint32_t exponent = (half >> 10) & 0x1Fu;
+	const uint32_t mantissa = half & 0x3FFu;
+	if (exponent == 0)
+	{
+		const float value = std::ldexp(static_cast<float>(mantissa), -24);
+		return sign ? -value : value;
+	}
+	if (exponent == 31)
+	{
+		return uintBitsToFloat(sign | 0x7F800000u | (mantissa << 13));
+	}
+	return uintBitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+static bool saveEXR(const std::vector<float>& data, const DumpHeader& header, int components, const std::string& path)
+{
+	const char* err = nullptr;
+	if (SaveEXR(data.data(), static_cast<int>(header.width), static_cast<int>(header.height), components, 0, path.c_str(), &err) != TINYEXR_SUCCESS)
+	{
+		std::cout << "ERROR: Failed to write " << path << (err ? std::string(": ") + err : std::string()) << std::endl;
+		FreeEXRErrorMessage(err);
+		return false;
+	}
+	std::cout << path << std::endl;
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: DecodeDump <file.dump> [output prefix]" << std::endl;
+		return 1;
+	}
+	const std::string path = argv[1];
+	std::string prefix = argc > 2 ? argv[2] : path;
+	if (argc <= 2 && prefix.size() > 5 && prefix.compare(prefix.size() - 5, 5, ".dump") == 0)
+	{
+		prefix.erase(prefix.size() - 5);
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	DumpHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, dumpMagic, sizeof(dumpMagic)) != 0 || header.version != dumpVersion)
+	{
+		std::cout << "ERROR: " << path << " is not a version " << dumpVersion << " dump" << std::endl;
+		return 1;
+	}
+	const DumpComponentType componentType = static_cast<DumpComponentType>(header.componentType);
+	const size_t componentSize = componentType == DumpComponentType::UInt8 ? 1 : 4;
+	const size_t texelCount = static_cast<size_t>(header.width) * header.height;
+	std::vector<unsigned char> texels(texelCount * header.channels * componentSize);
+	if (!file.read(reinterpret_cast<char*>(texels.data()), texels.size()))
+	{
+		std::cout << "ERROR: " << path << " is truncated" << std::endl;
+		return 1;
+	}
+	const std::string name(header.name, strnlen(header.name, sizeof(header.name)));
+	auto component = [&](size_t texel, uint32_t channel)
+	{
+		uint32_t value;
+		memcpy(&value, &texels[(texel * header.channels + channel) * 4], sizeof(value));
+		return value;
+	};
+	std::cout << name << ", frame " << header.frame << ", " << header.width << "x" << header.height << std::endl;
+
+	if ((name == "reprojection" || name == "filledReprojection") && componentType == DumpComponentType::UInt32)
+	{
+		// One channel is the packed format, the wide format is (relative position 16/16, depth bits)
+		const bool isWide = header.channels > 1;
+		std::vector<float> depth(texelCount);
+		std::vector<float> offset(texelCount * 3);
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			const uint32_t data = component(i, 0);
+			const bool isValid = (isWide ? component(i, 1) : data) != invalidReprojection;
+			int relativeX = 0;
+			int relativeY = 0;
+			depth[i] = -1.0f;
+			if (isValid && isWide)
+			{
+				relativeX = static_cast<int>(data >> 16) - 32768;
+				relativeY = static_cast<int>(data & 0xFFFFu) - 32768;
+				depth[i] = uintBitsToFloat(component(i, 1));
+			}
+			else if (isValid)
+			{
+				relativeX = static_cast<int>((data >> yBits) & ((1u << xBits) - 1u)) - (1 << (xBits - 1));
+				relativeY = static_cast<int>(data & ((1u << yBits) - 1u)) - (1 << (yBits - 1));
+				depth[i] = static_cast<float>(data >> (32 - depthBits)) / static_cast<float>((1u << depthBits) - 1u);
+			}
+			offset[i * 3 + 0] = static_cast<float>(relativeX);
+			offset[i * 3 + 1] = static_cast<float>(relativeY);
+			offset[i * 3 + 2] = isValid ? 1.0f : 0.0f;
+		}
+		return saveEXR(depth, header, 1, prefix + "_depth.exr") && saveEXR(offset, header, 3, prefix + "_offset.exr") ? 0 : 1;
+	}
+	if (name == "dilatedDepth" && componentType == DumpComponentType::UInt32)
+	{
+		// Geometry buffer: depth bits, packHalf2x16 motion vector
+		std::vector<float> depth(texelCount);
+		std::vector<float> motionVector(texelCount * 3);
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			depth[i] = uintBitsToFloat(component(i, 0));
+			const uint32_t packedMotionVector = component(i, 1);
+			motionVector[i * 3 + 0] = halfToFloat(static_cast<uint16_t>(packedMotionVector & 0xFFFFu));
+			motionVector[i * 3 + 1] = halfToFloat(static_cast<uint16_t>(packedMotionVector >> 16));
+			motionVector[i * 3 + 2] = 0.0f;
+		}
+		return saveEXR(depth, header, 1, prefix + "_depth.exr") && saveEXR(motionVector, header, 3, prefix + "_motion_vector.exr") ? 0 : 1;
+	}
+
+	if (name == "resolvedMotion" && componentType == DumpComponentType::UInt32)
+	{
+		// packHalf2x16 motion vectors at t1 and t0, INVALID t0 for the linear fallback
+		std::vector<float> motion_t1(texelCount * 3);
+		std::vector<float> motion_t0(texelCount * 3);
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			const uint32_t packed_t1 = component(i, 0);
+			const uint32_t packed_t0 = component(i, 1);
+			const bool isQuadratic = packed_t0 != invalidReprojection;
+			motion_t1[i * 3 + 0] = halfToFloat(static_cast<uint16_t>(packed_t1 & 0xFFFFu));
+			motion_t1[i * 3 + 1] = halfToFloat(static_cast<uint16_t>(packed_t1 >> 16));
+			motion_t1[i * 3 + 2] = 0.0f;
+			motion_t0[i * 3 + 0] = isQuadratic ? halfToFloat(static_cast<uint16_t>(packed_t0 & 0xFFFFu)) : 0.0f;
+			motion_t0[i * 3 + 1] = isQuadratic ? halfToFloat(static_cast<uint16_t>(packed_t0 >> 16)) : 0.0f;
+			motion_t0[i * 3 + 2] = isQuadratic ? 1.0f : 0.0f;
+		}
+		return saveEXR(motion_t1, header, 3, prefix + "_motion_t1.exr") && saveEXR(motion_t0, header, 3, prefix + "_motion_t0.exr") ? 0 : 1;
+	}
+
+	// SaveEXR takes 1, 3 or 4 channels
+	const int components = header.channels == 1 ? 1 : header.channels == 2 ? 3 : 4;
+	std::vector<float> image(texelCount * components, 0.0f);
+	for (size_t i = 0; i < texelCount; i++)
+	{
+		for (uint32_t c = 0; c < header.channels && c < 4; c++)
+		{
+			float value;
+			if (componentType == DumpComponentType::UInt8)
+			{
+				value = static_cast<float>(texels[i * header.channels + c]) / 255.0f;
+			}
+			else if (componentType == DumpComponentType::UInt32)
+			{
+				value = static_cast<float>(component(i, c));
+			}
+			else
+			{
+				value = uintBitsToFloat(component(i, c));
+			}
+			image[i * components + c] = value;
+		}
+	}
+	return saveEXR(image, header, components, prefix + ".exr") ? 0 : 1;
+}
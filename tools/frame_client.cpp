@@ -0,0 +1,403 @@
+// Reference client of the frame server (MobFGSR --serve <socket>), see src/frame_server_protocol.h:
+//   sends the frames of packed input directories (the view/depth/motion vector PNGs of the data set, at render size) and
+//   writes every output to <output directory>%04d.png
+//   --benchmark <count> submits the first frame count times instead and prints the loopback throughput and latency
+// Usage: MobFGSRClient <socket> --inputs <color dir> <depth dir> <mvx dir> <mvy dir> [--frames <start> <end>]
+//   [--jitter <file>] [--output <directory>] [--benchmark <count>] [--shutdown] [name=value ...]
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include "frame_server_protocol.h"
+
+struct Segment
+{
+	unsigned char* data = nullptr;
+	size_t size = 0;
+};
+
+static bool sendAll(int connection, const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	while (size > 0)
+	{
+		const ssize_t count = send(connection, bytes, size, MSG_NOSIGNAL);
+		if (count <= 0)
+		{
+			return false;
+		}
+		bytes += count;
+		size -= static_cast<size_t>(count);
+	}
+	return true;
+}
+
+static bool receiveAll(int connection, void* data, size_t size)
+{
+	unsigned char* bytes = static_cast<unsigned char*>(data);
+	while (size > 0)
+	{
+		const ssize_t count = recv(connection, bytes, size, 0);
+		if (count <= 0)
+		{
+			return false;
+		}
+		bytes += count;
+		size -= static_cast<size_t>(count);
+	}
+	return true;
+}
+
+// Sends a request and waits for its response, false with an ERROR message if it failed
+static bool request(int connection, FrameServerRequestType type, const std::string& options, FrameServerResponse& response)
+{
+	FrameServerRequest message;
+	memset(&message, 0, sizeof(message));
+	memcpy(message.magic, frameServerMagic, sizeof(frameServerMagic));
+	message.version = frameServerVersion;
+	message.type = static_cast<uint32_t>(type);
+	strncpy(message.options, options.c_str(), sizeof(message.options) - 1);
+	if (!sendAll(connection, &message, sizeof(message)) || !receiveAll(connection, &response, sizeof(response)))
+	{
+		std::cout << "ERROR: The frame server closed the connection" << std::endl;
+		return false;
+	}
+	if (response.status != 0)
+	{
+		std::cout << "ERROR: " << std::string(response.message, strnlen(response.message, sizeof(response.message))) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static bool mapSegment(const char* name, size_t size, Segment& segment)
+{
+	const int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+	{
+		std::cout << "ERROR: Cannot open shared memory " << name << std::endl;
+		return false;
+	}
+	void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		std::cout << "ERROR: Cannot map shared memory " << name << std::endl;
+		return false;
+	}
+	segment.data = static_cast<unsigned char*>(data);
+	segment.size = size;
+	return true;
+}
+
+static void unmapSegment(Segment& segment)
+{
+	if (segment.data)
+	{
+		munmap(segment.data, segment.size);
+		segment.data = nullptr;
+	}
+}
+
+// Value packed into RGBA8 as LoadDepth.comp and LoadMotionVector.comp decode it: the fetched texel (byte * 1/255) times
+// bitShift, summed in the order Mesa compiles the shader's x + y + z + w to. The served inputs then match the command
+// line exactly on llvmpipe, other drivers may round the sum differently in the last bit
+static float decodePacked(const unsigned char* texel)
+{
+	const float bitShift[4] = { 1.0f, 1.0f / 255.0f, 1.0f / (255.0f * 255.0f), 1.0f / (255.0f * 255.0f * 255.0f) };
+	float input[4];
+	for (int i = 0; i < 4; i++)
+	{
+		input[i] = static_cast<float>(texel[i]) * (1.0f / 255.0f) * bitShift[i];
+	}
+	return ((input[0] + input[2]) + input[3]) + input[1];
+}
+
+// Half float rounded toward zero, as Mesa stores the RG16F motion vectors of LoadMotionVector.comp (see src/cpu_image.cpp)
+static float roundToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = bits & 0x80000000u;
+	uint32_t magnitude = bits & 0x7FFFFFFFu;
+	if (magnitude >= 0x7F800000u)
+	{
+		return value;
+	}
+	if (magnitude < 0x38800000u)
+	{
+		return std::trunc(value * 16777216.0f) / 16777216.0f;
+	}
+	magnitude &= ~0x1FFFu;
+	if (magnitude > 0x477FE000u)
+	{
+		magnitude = 0x477FE000u;
+	}
+	bits = sign | magnitude;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static unsigned char* loadImage(const std::string& path, int width, int height)
+{
+	int w = 0;
+	int h = 0;
+	int channels = 0;
+	unsigned char* pixels = stbi_load(path.c_str(), &w, &h, &channels, 4);
+	if (!pixels || w != width || h != height)
+	{
+		std::cout << "ERROR: Cannot load " << path << " as a " << width << "x" << height << " image" << std::endl;
+		stbi_image_free(pixels);
+		return nullptr;
+	}
+	return pixels;
+}
+
+// Writes input frame of the directories into the planes of the input segment
+static bool loadFrame(const std::string directories[4], int frame, float jitterX, float jitterY, uint32_t width, uint32_t height,
+	unsigned char* input)
+{
+	char name[16];
+	snprintf(name, sizeof(name), "%04d.png", frame);
+	const int w = static_cast<int>(width);
+	const int h = static_cast<int>(height);
+	unsigned char* images[4] = {};
+	bool isLoaded = true;
+	for (int i = 0; i < 4 && isLoaded; i++)
+	{
+		images[i] = loadImage(directories[i] + name, w, h);
+		isLoaded = images[i] != nullptr;
+	}
+	if (isLoaded)
+	{
+		const size_t texelCount = static_cast<size_t>(width) * height;
+		FrameServerInputHeader header = { jitterX, jitterY };
+		memcpy(input, &header, sizeof(header));
+		memcpy(input + frameServerHeaderSize, images[0], texelCount * 4);
+		float* depth = reinterpret_cast<float*>(input + getInputDepthOffset(width, height));
+		float* motionVector = reinterpret_cast<float*>(input + getInputMotionVectorOffset(width, height));
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			depth[i] = decodePacked(images[1] + i * 4);
+			// To [-1, 1], y up and at the precision of the RG16F image as in LoadMotionVector.comp
+			motionVector[i * 2 + 0] = roundToHalf(decodePacked(images[2] + i * 4) * 2.0f - 1.0f);
+			motionVector[i * 2 + 1] = roundToHalf(-(decodePacked(images[3] + i * 4) * 2.0f - 1.0f));
+		}
+	}
+	for (unsigned char* image : images)
+	{
+		stbi_image_free(image);
+	}
+	return isLoaded;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: MobFGSRClient <socket> --inputs <color dir> <depth dir> <mvx dir> <mvy dir> [--frames <start> <end>]"
+			" [--jitter <file>] [--output <directory>] [--benchmark <count>] [--shutdown] [name=value ...]" << std::endl;
+		return 1;
+	}
+	const std::string socketPath = argv[1];
+	std::string directories[4];
+	int startFrame = 0;
+	int endFrame = 0;
+	std::string jitterPath;
+	std::string outputDirectory;
+	int benchmarkCount = 0;
+	bool shutdown = false;
+	std::string options;
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--inputs") == 0 && i + 4 < argc)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				directories[j] = argv[++i];
+			}
+		}
+		else if (strcmp(argv[i], "--frames") == 0 && i + 2 < argc)
+		{
+			startFrame = atoi(argv[++i]);
+			endFrame = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc)
+		{
+			jitterPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+		{
+			outputDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+		{
+			benchmarkCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--shutdown") == 0)
+		{
+			shutdown = true;
+		}
+		else if (strchr(argv[i], '='))
+		{
+			options += std::string(argv[i]) + "\n";
+		}
+		else
+		{
+			std::cout << "ERROR: Unknown argument " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+	if (!directories[0].empty() && startFrame > endFrame)
+	{
+		std::cout << "ERROR: --frames needs start <= end" << std::endl;
+		return 1;
+	}
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+	const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		std::cout << "ERROR: Cannot connect to " << socketPath << std::endl;
+		return 1;
+	}
+
+	FrameServerResponse response;
+	bool isSuccessful = true;
+	if (!directories[0].empty())
+	{
+		Segment input;
+		Segment output;
+		isSuccessful = request(connection, FrameServerRequestType::Open, options, response) &&
+			mapSegment(response.inputSegment, getInputSegmentSize(response.renderWidth, response.renderHeight), input) &&
+			mapSegment(response.outputSegment, getOutputSlotSize(response.presentationWidth, response.presentationHeight) * response.slotCount, output);
+		const uint32_t renderWidth = response.renderWidth;
+		const uint32_t renderHeight = response.renderHeight;
+		const uint32_t presentationWidth = response.presentationWidth;
+		const uint32_t presentationHeight = response.presentationHeight;
+		const uint32_t slotCount = response.slotCount;
+		const size_t slotSize = getOutputSlotSize(presentationWidth, presentationHeight);
+		if (isSuccessful)
+		{
+			std::cout << "Render " << renderWidth << "x" << renderHeight << ", presentation " << presentationWidth << "x"
+				<< presentationHeight << ", " << slotCount << " output slots" << std::endl;
+		}
+
+		// "<frame> <x> <y>" lines as inputLrJitterPath, frames without a line are not jittered
+		std::map<int, std::pair<float, float>> jitterOffsets;
+		if (isSuccessful && !jitterPath.empty())
+		{
+			std::ifstream jitterFile(jitterPath);
+			if (!jitterFile.is_open())
+			{
+				std::cout << "ERROR: Cannot open " << jitterPath << std::endl;
+				isSuccessful = false;
+			}
+			std::string line;
+			while (std::getline(jitterFile, line))
+			{
+				std::istringstream ss(line);
+				int frame;
+				float x;
+				float y;
+				if (!line.empty() && line[0] != '#' && ss >> frame >> x >> y)
+				{
+					jitterOffsets[frame] = std::make_pair(x, y);
+				}
+			}
+		}
+		auto readJitter = [&](int frame, float& jitterX, float& jitterY)
+		{
+			const auto jitter = jitterOffsets.find(frame);
+			jitterX = jitter != jitterOffsets.end() ? jitter->second.first : 0.0f;
+			jitterY = jitter != jitterOffsets.end() ? jitter->second.second : 0.0f;
+		};
+
+		if (isSuccessful && benchmarkCount > 0)
+		{
+			// Loads once, every submission moves the same planes through the segments
+			float jitterX;
+			float jitterY;
+			readJitter(startFrame, jitterX, jitterY);
+			isSuccessful = loadFrame(directories, startFrame, jitterX, jitterY, renderWidth, renderHeight, input.data);
+			uint64_t outputCount = 0;
+			double maxLatency = 0.0;
+			const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			for (int i = 0; i < benchmarkCount && isSuccessful; i++)
+			{
+				const std::chrono::steady_clock::time_point submitted = std::chrono::steady_clock::now();
+				isSuccessful = request(connection, FrameServerRequestType::Submit, "", response);
+				const double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitted).count();
+				maxLatency = latency > maxLatency ? latency : maxLatency;
+				outputCount += response.outputCount;
+			}
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+			if (isSuccessful)
+			{
+				const double bytes = static_cast<double>(benchmarkCount) * (getInputSegmentSize(renderWidth, renderHeight) - frameServerHeaderSize) +
+					static_cast<double>(outputCount) * (slotSize - frameServerHeaderSize);
+				printf("%d submits in %.3f s: %.2f submits/s, %.2f outputs/s, %.3f ms mean and %.3f ms max latency, %.1f MB/s through shared memory\n",
+					benchmarkCount, seconds, benchmarkCount / seconds, outputCount / seconds, seconds * 1000.0 / benchmarkCount, maxLatency,
+					bytes / seconds / (1024.0 * 1024.0));
+			}
+		}
+		else if (isSuccessful)
+		{
+			int outputIndex = 0;
+			for (int frame = startFrame; frame <= endFrame && isSuccessful; frame++, outputIndex += response.outputCount)
+			{
+				float jitterX;
+				float jitterY;
+				readJitter(frame, jitterX, jitterY);
+				isSuccessful = loadFrame(directories, frame, jitterX, jitterY, renderWidth, renderHeight, input.data) &&
+					request(connection, FrameServerRequestType::Submit, "", response);
+				for (uint32_t i = 0; i < response.outputCount && isSuccessful && !outputDirectory.empty(); i++)
+				{
+					const unsigned char* slot = output.data + slotSize * ((response.firstSlot + i) % slotCount);
+					char name[16];
+					snprintf(name, sizeof(name), "%04d.png", outputIndex + static_cast<int>(i));
+					if (!stbi_write_png((outputDirectory + name).c_str(), static_cast<int>(presentationWidth), static_cast<int>(presentationHeight),
+						4, slot + frameServerHeaderSize, 0))
+					{
+						std::cout << "ERROR: Cannot write " << outputDirectory + name << std::endl;
+						isSuccessful = false;
+					}
+				}
+			}
+			if (isSuccessful)
+			{
+				std::cout << endFrame - startFrame + 1 << " frames submitted, " << outputIndex << " outputs" << std::endl;
+			}
+		}
+		unmapSegment(input);
+		unmapSegment(output);
+		isSuccessful = request(connection, FrameServerRequestType::Close, "", response) && isSuccessful;
+	}
+	if (shutdown)
+	{
+		isSuccessful = request(connection, FrameServerRequestType::Shutdown, "", response) && isSuccessful;
+	}
+	close(connection);
+	return isSuccessful ? 0 : 1;
+}